@@ -0,0 +1,577 @@
+/*
+ * Benchmark of the pool algorithms (Impl) against new/delete and std::allocator
+ *
+ * For each object size, N (the count of live objects) and access pattern
+ * it measures ns/op (op - create or destroy), cache misses (if perf counters
+ * are available, otherwise null) and RSS. The result is written as JSON
+ * to stdout:
+ *
+ * ./bench > bench.json
+ * ./bench --quick          //only one object size and N (smoke run)
+ * ./bench --filter P_lb    //only benchmarks with the Impl name which contains "P_lb"
+ *
+ * The pattern "umap" is std::unordered_map<int, int> (insert + erase)
+ * with std::allocator and pool::allocator (Impl name "umap+P_lb").
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "pool.h"
+
+#if defined(__linux__)
+    #include <sys/resource.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+
+    #if __has_include(<linux/perf_event.h>)
+        #include <linux/perf_event.h>
+        #define BENCH_PERF_EVENT
+    #endif
+#endif
+
+
+
+
+using namespace pool;
+
+
+
+
+static const std::size_t OPS_TARGET = 1 << 21; //count of op for one benchmark
+static const std::size_t BLOCK_SIZE = 256;     //N for Pool_xxx_block
+
+
+volatile std::uintptr_t sink; //don't allow compiler to elide new/delete pairs
+
+
+
+
+template <std::size_t Size>
+struct Obj
+{
+    std::byte data[Size];
+
+    Obj() noexcept { data[0] = std::byte{1}; }
+};
+
+
+
+
+/*
+ * Counter of the cache misses (perf_event_open, Linux only).
+ * If the counter is not available (no permissions, VM, other OS),
+ * then the value is -1 and is written as null.
+ */
+class Perf_counter
+{
+    public:
+        Perf_counter() noexcept
+        {
+        #if defined(BENCH_PERF_EVENT)
+            perf_event_attr attr{};
+
+            attr.type           = PERF_TYPE_HARDWARE;
+            attr.size           = sizeof(attr);
+            attr.config         = PERF_COUNT_HW_CACHE_MISSES;
+            attr.disabled       = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv     = 1;
+
+            m_fd = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+        #endif
+        }
+
+        ~Perf_counter() noexcept
+        {
+        #if defined(BENCH_PERF_EVENT)
+            if(m_fd >= 0)
+                close(m_fd);
+        #endif
+        }
+
+        Perf_counter(const Perf_counter&)            = delete;
+        Perf_counter& operator=(const Perf_counter&) = delete;
+
+        void start() noexcept
+        {
+        #if defined(BENCH_PERF_EVENT)
+            if(m_fd < 0)
+                return;
+
+            ioctl(m_fd, PERF_EVENT_IOC_RESET,  0);
+            ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+        #endif
+        }
+
+        long long stop() noexcept
+        {
+            long long value = -1;
+
+        #if defined(BENCH_PERF_EVENT)
+            if(m_fd < 0)
+                return value;
+
+            ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+
+            if(read(m_fd, &value, sizeof(value)) != sizeof(value))
+                value = -1;
+        #endif
+
+            return value;
+        }
+
+
+    private:
+        int m_fd = -1;
+};
+
+
+
+
+//Current resident set size in KiB (0 if unknown)
+static long rss_kb() noexcept
+{
+#if defined(__linux__)
+    long  size  = 0;
+    long  pages = 0;
+    FILE *f     = std::fopen("/proc/self/statm", "r");
+
+    if(!f)
+        return 0;
+
+    if(std::fscanf(f, "%ld %ld", &size, &pages) != 2)
+        pages = 0;
+
+    std::fclose(f);
+
+    return pages * (sysconf(_SC_PAGESIZE) / 1024);
+#else
+    return 0;
+#endif
+}
+
+
+
+//Peak resident set size in KiB (0 if unknown)
+static long max_rss_kb() noexcept
+{
+#if defined(__linux__)
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+
+    return usage.ru_maxrss;
+#else
+    return 0;
+#endif
+}
+
+
+
+
+/*
+ * Allocators under test, all of them have the same interface:
+ * create(), destroy(T*), create_n(T**, n), destroy_n(T* const*, n)
+ */
+template <class T, std::size_t N,
+          template <typename, std::size_t, std::size_t, Pool_flags_t, typename...> class Impl>
+struct Pool_alloc
+{
+    Pool<T, N, alignof(T), 0, Impl> pool;
+
+    T*   create()         { return pool.create(); }
+    void destroy(T* obj)  { pool.destroy(obj);    }
+
+    std::size_t create_n(T** objs, std::size_t n)  { return pool.create_n(objs, n); }
+    void destroy_n(T* const* objs, std::size_t n)  { pool.destroy_n(objs, n);       }
+};
+
+
+
+template <class T>
+struct New_alloc
+{
+    T*   create()         { return new T; }
+    void destroy(T* obj)  { delete obj;   }
+
+    std::size_t create_n(T** objs, std::size_t n)
+    {
+        for(std::size_t i = 0; i < n; i++)
+            objs[i] = create();
+
+        return n;
+    }
+
+    void destroy_n(T* const* objs, std::size_t n)
+    {
+        for(std::size_t i = 0; i < n; i++)
+            destroy(objs[i]);
+    }
+};
+
+
+
+template <class T>
+struct Std_alloc
+{
+    std::allocator<T> alloc;
+
+    T* create()
+    {
+        return ::new ((void *)alloc.allocate(1)) T;
+    }
+
+    void destroy(T* obj)
+    {
+        std::destroy_at(obj);
+        alloc.deallocate(obj, 1);
+    }
+
+    std::size_t create_n(T** objs, std::size_t n)
+    {
+        for(std::size_t i = 0; i < n; i++)
+            objs[i] = create();
+
+        return n;
+    }
+
+    void destroy_n(T* const* objs, std::size_t n)
+    {
+        for(std::size_t i = 0; i < n; i++)
+            destroy(objs[i]);
+    }
+};
+
+
+
+
+/*
+ * Access patterns. Each of them does ops (create + destroy) over N live
+ * objects and returns the count of done ops.
+ */
+enum class Pattern { LIFO, FIFO, RANDOM, BULK, UMAP };
+
+static const char* pattern_name(Pattern p)
+{
+    switch(p)
+    {
+        case Pattern::LIFO:   return "lifo";
+        case Pattern::FIFO:   return "fifo";
+        case Pattern::RANDOM: return "random";
+        case Pattern::BULK:   return "bulk";
+        case Pattern::UMAP:   return "umap";
+    }
+
+    return "";
+}
+
+
+
+static std::uint64_t xorshift(std::uint64_t &state)
+{
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    return state;
+}
+
+
+
+template <class Alloc, class T>
+static std::size_t run_pattern(Alloc &alloc, Pattern pattern, std::vector<T*> &objs)
+{
+    const std::size_t N    = objs.size();
+    const std::size_t reps = std::max<std::size_t>(1, OPS_TARGET / (2 * N));
+
+    std::uintptr_t acc = 0;
+    std::size_t    ops = 0;
+
+    switch(pattern)
+    {
+        case Pattern::LIFO:
+        case Pattern::FIFO:
+            for(std::size_t r = 0; r < reps; r++)
+            {
+                for(auto &obj: objs)
+                {
+                    obj  = alloc.create();
+                    acc ^= (std::uintptr_t)obj;
+                }
+
+                if(pattern == Pattern::LIFO)
+                {
+                    for(std::size_t i = N; i > 0; i--)
+                        alloc.destroy(objs[i - 1]);
+                }
+                else
+                {
+                    for(auto obj: objs)
+                        alloc.destroy(obj);
+                }
+
+                ops += 2 * N;
+            }
+            break;
+
+
+        case Pattern::RANDOM: //churn: random create/destroy around N/2 live objects
+        {
+            std::uint64_t state = 88172645463325252ull;
+            std::size_t   live  = 0;
+
+            for(; live < N / 2; live++)
+                objs[live] = alloc.create();
+
+            for(std::size_t i = 0; i < reps * 2 * N; i++)
+            {
+                auto rnd = xorshift(state);
+
+                if(live < N && (live == 0 || (rnd & 1)))
+                {
+                    objs[live] = alloc.create();
+                    acc       ^= (std::uintptr_t)objs[live++];
+                }
+                else
+                {
+                    auto j = (rnd >> 1) % live;
+
+                    alloc.destroy(objs[j]);
+                    objs[j] = objs[--live];
+                }
+            }
+
+            for(std::size_t i = 0; i < live; i++)
+                alloc.destroy(objs[i]);
+
+            ops += reps * 2 * N + N / 2 + live;
+            break;
+        }
+
+
+        case Pattern::BULK:
+            for(std::size_t r = 0; r < reps; r++)
+            {
+                auto cnt = alloc.create_n(objs.data(), N);
+                acc     ^= (std::uintptr_t)objs[0];
+
+                alloc.destroy_n(objs.data(), cnt);
+                ops += 2 * N;
+            }
+            break;
+
+
+        case Pattern::UMAP: //see run_map
+            break;
+    }
+
+    sink = acc;
+
+    return ops;
+}
+
+
+
+
+//Node container: N inserts + N erases
+template <class Map>
+static std::size_t run_map(std::size_t N)
+{
+    const std::size_t reps = std::max<std::size_t>(1, OPS_TARGET / (2 * N));
+
+    Map         map;
+    std::size_t ops = 0;
+
+    for(std::size_t r = 0; r < reps; r++)
+    {
+        for(std::size_t i = 0; i < N; i++)
+            map.emplace((int)i, (int)r);
+
+        sink = map.size();
+
+        for(std::size_t i = 0; i < N; i++)
+            map.erase((int)i);
+
+        ops += 2 * N;
+    }
+
+    return ops;
+}
+
+
+
+
+struct Result
+{
+    std::string name;
+    std::size_t obj_size;
+    std::size_t n;
+    Pattern     pattern;
+    double      ns_per_op;
+    long long   cache_misses;
+    long        rss_kb;
+};
+
+
+
+struct Bench
+{
+    Perf_counter          perf;
+    std::vector<Result>   results;
+    std::string           filter;
+
+
+    template <class Alloc, class T>
+    void run(const char *name, std::size_t N)
+    {
+        if(!filter.empty() && std::string(name).find(filter) == std::string::npos)
+            return;
+
+        for(auto pattern: {Pattern::LIFO, Pattern::FIFO, Pattern::RANDOM, Pattern::BULK})
+        {
+            auto            alloc = std::make_unique<Alloc>(); //static pools may be big
+            std::vector<T*> objs(N);
+
+            measure(name, sizeof(T), N, pattern, [&]{ return run_pattern(*alloc, pattern, objs); });
+        }
+    }
+
+
+    template <class Map>
+    void run_umap(const char *name, std::size_t N)
+    {
+        if(!filter.empty() && std::string(name).find(filter) == std::string::npos)
+            return;
+
+        measure(name, sizeof(typename Map::value_type), N, Pattern::UMAP, [&]{ return run_map<Map>(N); });
+    }
+
+
+    //f() does the ops and returns their count, the first call is warm up
+    //(dynamic pools grow here)
+    template <class F>
+    void measure(const char *name, std::size_t obj_size, std::size_t N, Pattern pattern, F f)
+    {
+        f();
+
+        perf.start();
+        auto start = std::chrono::steady_clock::now();
+
+        auto ops = f();
+
+        auto stop   = std::chrono::steady_clock::now();
+        auto misses = perf.stop();
+        auto ns     = std::chrono::duration<double, std::nano>(stop - start).count();
+
+        results.push_back({name, obj_size, N, pattern, ns / ops, misses, rss_kb()});
+    }
+
+
+    template <std::size_t Size, std::size_t N>
+    void run_all()
+    {
+        using T = Obj<Size>;
+
+        run<New_alloc<T>,                       T>("new",  N);
+        run<Std_alloc<T>,                       T>("std::allocator", N);
+
+        run<Pool_alloc<T, N, SPool_list>,        T>("SP_l",  N);
+        run<Pool_alloc<T, N, SPool_list_bitset>, T>("SP_b",  N);
+        run<Pool_alloc<T, N, SPool_bitmap>,      T>("SP_bm", N);
+        run<Pool_alloc<T, N, SPool_dlist>,       T>("SP_dl", N);
+        run<Pool_alloc<T, N, SPool_idlist>,      T>("SP_idl", N);
+
+        run<Pool_alloc<T, BLOCK_SIZE, Pool_list>,        T>("P_l",   N);
+        run<Pool_alloc<T, BLOCK_SIZE, Pool_dlist>,       T>("P_dl",  N);
+        run<Pool_alloc<T, BLOCK_SIZE, Pool_list_block>,  T>("P_lb",  N);
+        run<Pool_alloc<T, BLOCK_SIZE, Pool_dlist_block>, T>("P_dlb", N);
+    }
+
+
+    template <std::size_t N>
+    void run_umaps()
+    {
+        using Value = std::pair<const int, int>;
+
+        run_umap<std::unordered_map<int, int>>("umap+std::allocator", N);
+        run_umap<std::unordered_map<int, int, std::hash<int>, std::equal_to<int>,
+                                    pool::allocator<Value, BLOCK_SIZE, Pool_list_block>>>("umap+P_lb", N);
+    }
+
+
+    void print_json() const
+    {
+        std::printf("{\n");
+        std::printf("  \"ops_target\": %zu,\n", OPS_TARGET);
+        std::printf("  \"block_size\": %zu,\n", BLOCK_SIZE);
+        std::printf("  \"max_rss_kb\": %ld,\n", max_rss_kb());
+        std::printf("  \"benchmarks\": [\n");
+
+        for(std::size_t i = 0; i < results.size(); i++)
+        {
+            const auto &r = results[i];
+
+            std::printf("    {\"impl\": \"%s\", \"obj_size\": %zu, \"n\": %zu, "
+                        "\"pattern\": \"%s\", \"ns_per_op\": %.3f, ",
+                        r.name.c_str(), r.obj_size, r.n, pattern_name(r.pattern), r.ns_per_op);
+
+            if(r.cache_misses < 0)
+                std::printf("\"cache_misses\": null, ");
+            else
+                std::printf("\"cache_misses\": %lld, ", r.cache_misses);
+
+            std::printf("\"rss_kb\": %ld}%s\n", r.rss_kb, i + 1 < results.size() ? "," : "");
+        }
+
+        std::printf("  ]\n");
+        std::printf("}\n");
+    }
+};
+
+
+
+
+int main(int argc, char *argv[])
+{
+    Bench bench;
+    bool  quick = false;
+
+    for(int i = 1; i < argc; i++)
+    {
+        if(!std::strcmp(argv[i], "--quick"))
+            quick = true;
+        else if(!std::strcmp(argv[i], "--filter") && i + 1 < argc)
+            bench.filter = argv[++i];
+        else
+        {
+            std::fprintf(stderr, "usage: %s [--quick] [--filter name]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    bench.run_all<64, 4096>();
+    bench.run_umaps<4096>();
+
+    if(!quick)
+    {
+        bench.run_all<8,   256>();
+        bench.run_all<8,   4096>();
+        bench.run_all<8,   65536>();
+        bench.run_all<64,  256>();
+        bench.run_all<64,  65536>();
+        bench.run_all<256, 256>();
+        bench.run_all<256, 4096>();
+        bench.run_all<256, 65536>();
+        bench.run_umaps<256>();
+        bench.run_umaps<65536>();
+    }
+
+    bench.print_json();
+
+    return 0;
+}
@@ -40,13 +40,66 @@
 #define POOL_H
 
 #include <array>
-#include <bitset>
+#include <algorithm>
+#include <mutex>
+#include <atomic>
 #include <memory>
 #include <cstdint>
 #include <cstddef>
+#include <climits>
+#include <cstdio>
+#include <cstring>
 #include <iterator>
+#include <new>
+#include <thread>
+#include <exception>
+#include <tuple>
+#include <utility>
 #include <type_traits>
 
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #define POOL_MMAP
+#endif
+
+#if __has_include(<memory_resource>)
+    #include <memory_resource>
+    #define POOL_MEMORY_RESOURCE
+#endif
+
+//The size of cache line for POOL_CACHE_LINE. It's a constant (not
+//std::hardware_destructive_interference_size) because it changes the layout
+//of pools: GCC warns that the value depends on -mtune. Define it to override.
+#ifndef POOL_CACHE_LINE_SIZE
+    #define POOL_CACHE_LINE_SIZE 64
+#endif
+
+
+//The static probes (USDT) of the provider "pool" for bpftrace/perf/systemtap:
+//create, create_n, destroy, destroy_n (pool, object or count, size) and
+//grow, shrink (pool, node or block, capacity). They are compiled only if
+//POOL_USDT is defined (needs <sys/sdt.h>), without it they are empty.
+#if defined(POOL_USDT)
+    #if !__has_include(<sys/sdt.h>)
+        #error "POOL_USDT needs <sys/sdt.h> (systemtap-sdt-dev)"
+    #endif
+    #include <sys/sdt.h>
+    #define POOL_PROBE(name, pool_ptr, arg, n) DTRACE_PROBE3(pool, name, pool_ptr, arg, n)
+#else
+    #define POOL_PROBE(name, pool_ptr, arg, n) ((void)0)
+#endif
+
 
 
 
@@ -61,6 +114,106 @@ template <typename T, typename... Args>
 
 
 
+//Count trailing/leading zeros, x must not be zero
+inline unsigned ctz64(std::uint64_t x) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long i;
+    _BitScanForward64(&i, x);
+    return i;
+#else
+    unsigned i = 0;
+    for(; !(x & 1); x >>= 1) i++;
+    return i;
+#endif
+}
+
+
+inline unsigned clz64(std::uint64_t x) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_clzll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long i;
+    _BitScanReverse64(&i, x);
+    return 63 - i;
+#else
+    unsigned i = 0;
+    for(; !(x & (std::uint64_t(1) << 63)); x <<= 1) i++;
+    return i;
+#endif
+}
+
+
+
+//Untyped storage of Size bytes for the pools of raw memory (not objects).
+//The ctor is user-provided and empty: create() doesn't zero the memory.
+template <std::size_t Size, std::size_t Align>
+struct Raw_storage
+{
+    alignas(Align) std::byte data[Size];
+
+    Raw_storage() noexcept {}
+};
+
+
+
+//The counters of the concurrent pools (m_size, m_capacity) are atomic
+template <typename T> inline constexpr bool is_atomic_counter                 = false;
+template <typename T> inline constexpr bool is_atomic_counter<std::atomic<T>> = true;
+
+
+
+//RAII for the create_n methods. The algorithm detaches n nodes from
+//the free list (objs[0..n)) and creates objects in them (cnt - count of
+//the created objects). If ctor of object will thrown an exception, then
+//the created objects are destroyed and the rest of nodes are returned
+//to the free list. It is needed for strong exception guarantee.
+template <typename T, class Alg>
+struct create_n_saver
+{
+    Alg         &alg;
+    T          **objs;
+    std::size_t  n   = 0;
+    std::size_t  cnt = 0;
+
+    ~create_n_saver() noexcept
+    {
+        if(cnt == n)
+            return;
+
+        for(std::size_t i = 0; i < cnt; i++)
+            alg.destroy_obj(objs[i]);
+
+        for(std::size_t i = cnt; i < n; i++)
+            alg.release_node(objs[i]);
+    }
+};
+
+
+
+//RAII for the create_n methods which create objects in several batches
+//(create_n_saver rolls back only the current batch). If ctor of object
+//will thrown an exception, then the objects of the done batches
+//objs[0..cnt) are destroyed too.
+template <typename T, class Alg>
+struct create_n_rollback
+{
+    Alg         &alg;
+    T          **objs;
+    std::size_t  cnt = 0;
+
+    ~create_n_rollback() noexcept
+    {
+        for(std::size_t i = 0; i < cnt; i++)
+            alg.destroy_obj(objs[i]);
+    }
+};
+
+
+
 template <class Impl,
           class Value,
           class Category   = std::bidirectional_iterator_tag,
@@ -133,10 +286,86 @@ enum Pool_flags: Pool_flags_t
     POOL_SELF_MOVE_GUARD  = (1u << 2), //C++ Core Guidelines c65-make-move-assignment-safe-for-self-assignment
     POOL_CREATE_EXCEPTION = (1u << 3), //Throw std::bad_alloc exception if no memory
     POOL_RESERVE_EXCEPTION= (1u << 4), //Throw std::bad_alloc exception if no memory
+    POOL_MMAP_BLOCKS      = (1u << 5), //Map blocks via mmap (huge pages if possible), only for Pool_xxx_block
+    POOL_GROW_BLOCKS      = (1u << 6), //Block size doubles N, 2N, 4N... up to the limit, only for Pool_xxx_block
+    POOL_TRIM_BLOCKS      = (1u << 7), //Release the empty blocks of non-empty pool, only for Pool_xxx_block
+    POOL_FULLEST_BLOCK    = (1u << 8), //Create objects in the fullest block (implies POOL_TRIM_BLOCKS), only for Pool_xxx_block
+    POOL_HANDLES          = (1u << 9), //The 32-bit handles of objects (slot + generation), only for SPool_xxx and Pool_xxx_block
+    POOL_HANDLES_64       = (1u << 10),//The 64-bit handles of objects
+    POOL_SPLIT_NODES      = (1u << 11),//The links of nodes are in a separate array (hot/cold), xxx_idlist/xxx_dlist
+    POOL_CACHE_LINE       = (1u << 12),//Each object takes its own cache lines (no false sharing)
+    POOL_STATS            = (1u << 13),//Count the statistics of pool (see Pool_stats)
 };
 
 
 
+/*
+ * The limit of the block size for POOL_GROW_BLOCKS.
+ *
+ * The limit is stored in the high bits of flags: bits 24..29 - log2(limit)
+ * (the limit is rounded down to a power of two), bit 30 - the limit is in bytes
+ * of the block (else in nodes). Without the limit the block is up to 2 MiB.
+ * The block is never smaller than N nodes.
+ *
+ * Pool<Msg, 64, alignof(Msg), pool_grow_blocks_bytes(2 << 20), Pool_list_block>
+ */
+inline constexpr Pool_flags_t POOL_GROW_LIMIT_SHIFT = 24;
+inline constexpr Pool_flags_t POOL_GROW_LIMIT_MASK  = 0x3fu << POOL_GROW_LIMIT_SHIFT;
+inline constexpr Pool_flags_t POOL_GROW_LIMIT_BYTES = (1u << 30);
+inline constexpr std::size_t  POOL_GROW_BLOCK_SIZE  = std::size_t(2) << 20; //default limit (bytes)
+
+
+constexpr Pool_flags_t pool_log2(std::size_t x) noexcept
+{
+    Pool_flags_t i = 0;
+    for(; x > 1; x >>= 1) i++;
+    return i;
+}
+
+constexpr Pool_flags_t pool_grow_blocks_bytes(std::size_t max_bytes) noexcept
+{
+    return POOL_GROW_BLOCKS | POOL_GROW_LIMIT_BYTES | (pool_log2(max_bytes) << POOL_GROW_LIMIT_SHIFT);
+}
+
+constexpr Pool_flags_t pool_grow_blocks_nodes(std::size_t max_nodes) noexcept
+{
+    //log2 == 0 is reserved for the default limit, 1 node is less than N anyway
+    return max_nodes > 1 ? POOL_GROW_BLOCKS | (pool_log2(max_nodes) << POOL_GROW_LIMIT_SHIFT)
+                         : pool_grow_blocks_bytes(0);
+}
+
+
+
+//The alignment of objects in nodes (POOL_CACHE_LINE aligns them to the cache line)
+constexpr std::size_t pool_data_align(std::size_t align, Pool_flags_t flags) noexcept
+{
+    return (flags & POOL_CACHE_LINE) ? std::max<std::size_t>(align, POOL_CACHE_LINE_SIZE) : align;
+}
+
+
+
+constexpr bool pool_handles(Pool_flags_t flags) noexcept
+{
+    return flags & (POOL_HANDLES | POOL_HANDLES_64);
+}
+
+//The value of handle and the generation of slot (POOL_HANDLES, POOL_HANDLES_64)
+template <Pool_flags_t Flags>
+using pool_handle_value_t = std::conditional_t<(Flags & POOL_HANDLES_64) != 0, std::uint64_t, std::uint32_t>;
+
+template <Pool_flags_t Flags>
+using pool_handle_gen_t   = std::conditional_t<(Flags & POOL_HANDLES_64) != 0, std::uint32_t, std::uint16_t>;
+
+//The count of bits for the values 0..x
+constexpr std::size_t pool_bit_width(std::size_t x) noexcept
+{
+    std::size_t i = 0;
+    for(; x; x >>= 1) i++;
+    return i;
+}
+
+
+
 
 
 template <class Impl, Pool_flags_t Flags, typename Enable = void>
@@ -157,12 +386,124 @@ class Pool_dtor<Impl, Flags, std::enable_if_t< (Flags & POOL_DTOR_OFF) > >
 
 
 
+//The snapshot of statistics of pool (POOL_STATS), see stats()
+struct Pool_stats
+{
+    std::size_t creates;        //count of created objects
+    std::size_t destroys;       //count of destroyed objects
+    std::size_t grows;          //count of allocated nodes (Pool_xxx) or blocks (Pool_xxx_block)
+    std::size_t failed_grows;   //count of failed allocations of nodes or blocks
+    std::size_t shrinks;        //count of released nodes or blocks
+    std::size_t size;
+    std::size_t high_water;     //the peak of size
+    std::size_t capacity;
+    std::size_t bytes_reserved; //the memory of nodes with the headers of blocks (the size of static pool)
+    std::size_t bytes_per_node; //the stride of nodes
+    double      padding;        //the fraction of node which isn't the object (links, padding)
+};
+
+
+
+//POOL_STATS: the counters (the destroys are creates - size)
+struct Pool_counters
+{
+    std::size_t m_creates      = 0;
+    std::size_t m_high_water   = 0;
+    std::size_t m_grows        = 0;
+    std::size_t m_failed_grows = 0;
+    std::size_t m_shrinks      = 0;
+};
+
+struct Pool_no_counters {};
+
+
+
+//The count of objects in one part of parallel_for_each (the smaller pools are walked by the caller)
+#ifndef POOL_PARALLEL_GRAIN
+    #define POOL_PARALLEL_GRAIN 1024
+#endif
+
+
+//The count of threads for parallel_for_each (0 - all cores)
+inline std::size_t pool_threads(std::size_t threads) noexcept
+{
+    return threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+
+//Runs task(0) ... task(parts - 1) in the caller and threads - 1 new threads.
+//The exception of task is rethrown in the caller (after all threads are joined).
+//If the threads can't be created, the rest of work is done by the caller.
+template <class Task>
+void pool_parallel_run(std::size_t threads, std::size_t parts, Task& task)
+{
+    std::atomic<std::size_t> next{0};
+    std::exception_ptr       error;
+    std::mutex               error_mutex;
+
+    auto worker = [&]()
+    {
+        for(auto i = next.fetch_add(1); i < parts; i = next.fetch_add(1))
+        {
+            try
+            {
+                task(i);
+            }
+            catch(...)
+            {
+                std::lock_guard<std::mutex> lock(error_mutex);
+
+                if(!error)
+                    error = std::current_exception();
+
+                next = parts; //the rest of parts are skipped
+            }
+        }
+    };
+
+    threads = std::min(threads, parts);
+
+    std::unique_ptr<std::thread[]> workers;
+    std::size_t                    started = 0;
+
+    try
+    {
+        if(threads > 1)
+            workers.reset(new std::thread[threads - 1]);
+
+        for(; started + 1 < threads; started++)
+            workers[started] = std::thread(worker);
+    }
+    catch(...) {}
+
+    worker();
+
+    for(std::size_t i = 0; i < started; i++)
+        workers[i].join();
+
+    if(error)
+        std::rethrow_exception(error);
+}
+
+
+template <class Pool, class Value, std::size_t N>
+class Iterator_bitset;
+
+template <class Iterator>
+inline constexpr bool is_iterator_bitset = false;
+
+template <class Pool, class Value, std::size_t N>
+inline constexpr bool is_iterator_bitset<Iterator_bitset<Pool, Value, N>> = true;
+
+
+
 template <typename     T,
           std::size_t  N,
           std::size_t  Align,
           Pool_flags_t Flags,
-          class        Impl>
-class Pool_base
+          class        Impl,
+          typename     Counter = std::size_t>
+class Pool_base: public std::conditional_t<(Flags & POOL_STATS) != 0, Pool_counters, Pool_no_counters>
 {
     static_assert(Align > 0, "Align == 0 is not support");
     static_assert(Align >= alignof(T), "Align can't be less than the requirements of the type");
@@ -188,1260 +529,5263 @@ class Pool_base
         template <typename... Args>
         T* create(Args&&... args) noexcept(is_nothrow_create<T, Args...>)
         {
-            return impl().create_obj(std::forward<Args>(args)...);
+            auto obj = impl().create_obj(std::forward<Args>(args)...);
+            stat_create(obj != nullptr);
+            POOL_PROBE(create, &impl(), obj, size());
+            return obj;
         }
 
+        //Creates up to n objects (each object is created from args)
+        //and writes pointers to objs. Returns the count of created objects.
+        template <typename... Args>
+        std::size_t create_n(T** objs, std::size_t n, const Args&... args)
+            noexcept(is_nothrow_create<T, const Args&...>)
+        {
+            auto cnt = impl().create_n_obj(objs, n, args...);
+            stat_create(cnt);
+            POOL_PROBE(create_n, &impl(), cnt, size());
+            return cnt;
+        }
 
-    protected:
-        std::size_t m_size = 0;
 
-        // Curiously Recurring Template interface
-        constexpr       Impl& impl()       { return *static_cast<      Impl*>(this); }
-        constexpr const Impl& impl() const { return *static_cast<const Impl*>(this); }
-};
+        //POOL_STATS: the snapshot of counters, O(1) (O(blocks) for Pool_xxx_block)
+        Pool_stats stats() const noexcept
+        {
+            static_assert(Flags & POOL_STATS, "stats needs the flag POOL_STATS");
+
+            Pool_stats st{};
+
+            st.creates        = this->m_creates;
+            st.destroys       = this->m_creates - size();
+            st.grows          = this->m_grows;
+            st.failed_grows   = this->m_failed_grows;
+            st.shrinks        = this->m_shrinks;
+            st.size           = size();
+            st.high_water     = this->m_high_water;
+            st.capacity       = impl().capacity();
+            st.bytes_reserved = impl().reserved_bytes();
+            st.bytes_per_node = impl().node_bytes();
+            st.padding        = 1.0 - double(sizeof(T)) / double(st.bytes_per_node);
+
+            return st;
+        }
 
 
+        //Calls f for each object in parallel (for the pools with iterators).
+        //ex is the count of threads (0 - all cores) or the executor: a callable
+        //ex(parts, task) which calls task(0) ... task(parts - 1) and returns when they are done.
+        //f must not create/destroy objects of this pool, its exception is rethrown
+        //(the other parts may be done or skipped).
+        template <typename UnaryFunction, typename Executor = std::size_t>
+        void parallel_for_each(UnaryFunction f, Executor ex = 0)
+        {
+            if(empty())
+                return;
 
+            std::size_t parts = (size() + POOL_PARALLEL_GRAIN - 1) / POOL_PARALLEL_GRAIN;
 
+            if constexpr(std::is_integral_v<Executor>)
+                parts = std::min(parts, 4 * pool_threads(ex)); //4 parts per thread to balance them
 
-template <typename T>
-constexpr Pool_flags_t SPool_base_flags(Pool_flags_t Flags)
-{
-    return std::is_trivially_destructible_v<T> ? (Flags | POOL_DTOR_OFF) : Flags;
-}
+            using iterator = typename Impl::iterator;
 
+            std::unique_ptr<iterator[]> bounds(new iterator[parts + 1]);
+            parts = parallel_bounds(bounds.get(), parts);
 
+            auto task = [&f, &bounds](std::size_t i)
+            {
+                for(auto it = bounds[i]; it != bounds[i + 1]; ++it)
+                    f(&*it);
+            };
 
-template <typename     T,
-          std::size_t  N,
-          std::size_t  Align,
-          Pool_flags_t Flags,
-          class        Impl>
-class SPool_base: public Pool_base<T, N, Align, Flags, Impl>,
-                  public Pool_dtor<Impl, SPool_base_flags<T>(Flags)>
-{
-    public:
-        SPool_base() = default;
+            if(parts == 1)
+                task(0);
+            else if constexpr(std::is_integral_v<Executor>)
+                pool_parallel_run(pool_threads(ex), parts, task);
+            else
+                ex(parts, task);
+        }
 
-        static constexpr std::size_t capacity() noexcept { return N; }
 
-        // disable copy/move semantics
-        SPool_base(const SPool_base&)            = delete;
-        SPool_base(SPool_base&&)                 = delete;
-        SPool_base& operator=(const SPool_base&) = delete;
-        SPool_base& operator=(SPool_base&&)      = delete;
+        //destroy_all: the destructors are called in parallel (see parallel_for_each),
+        //then the nodes are returned to the pool by the caller
+        template <typename Executor = std::size_t>
+        void parallel_destroy_all(Executor ex = 0)
+        {
+            if constexpr( !std::is_trivially_destructible_v<T> )
+                parallel_for_each([](T* obj){ std::destroy_at(obj); }, ex);
 
-    protected:
-        void dtor() noexcept { this->impl().destroy_all(); }
+            impl().release_all();
+        }
 
-        friend Pool_dtor<Impl, SPool_base_flags<T>(Flags)>;
-};
 
+    protected:
+        Counter m_size{0};
 
 
+        //The bounds of parts of parallel_for_each (the part i is [bounds[i], bounds[i + 1]) ):
+        //the ranges of slots for the bitset pools, the chunks of the used list (one walk) for others.
+        //Returns the count of parts.
+        template <class Iterator>
+        std::size_t parallel_bounds(Iterator* bounds, std::size_t parts)
+        {
+            if constexpr(is_iterator_bitset<Iterator>)
+            {
+                for(std::size_t i = 0; i < parts; i++)
+                    bounds[i] = Iterator(&impl(), i * N / parts);
 
+                bounds[parts] = impl().end();
+                return parts;
+            }
+            else
+            {
+                const auto  step = (size() + parts - 1) / parts;
+                std::size_t cnt  = 0;
+                std::size_t i    = 0;
 
-template <typename     T,
-          std::size_t  N,
-          std::size_t  Align,
-          Pool_flags_t Flags,
-          class        Impl>
-class DPool_base: public Pool_base<T, N, Align, Flags, Impl>,
-                  public Pool_dtor<Impl, Flags>
-{
-    public:
-        DPool_base() = default;
+                for(auto it = impl().begin(); it != impl().end(); ++it, i++)
+                {
+                    if(i % step == 0)
+                        bounds[cnt++] = it;
+                }
 
-        constexpr std::size_t capacity() const noexcept { return m_capacity; }
+                bounds[cnt] = impl().end();
+                return cnt;
+            }
+        }
 
-        template <typename... Args>
-        T* create(Args&&... args) noexcept(is_nothrow_create<T, Args...>)
+
+        //The counters of POOL_STATS (without the flag they are empty)
+        constexpr void stat_create(std::size_t n) noexcept
         {
-            if constexpr ( !(Flags & POOL_FIXED_CAPACITY) )
+            if constexpr(Flags & POOL_STATS)
             {
-                if(this->full())
-                    this->impl().add_node();
+                this->m_creates   += n;
+                this->m_high_water = std::max<std::size_t>(this->m_high_water, m_size);
             }
-
-            return this->impl().create_obj(std::forward<Args>(args)...);
         }
 
+        constexpr void stat_grow(bool ok) noexcept
+        {
+            if constexpr(Flags & POOL_STATS)
+                (ok ? this->m_grows : this->m_failed_grows)++;
+        }
 
-        void reserve(std::size_t new_cap) noexcept( !(Flags & POOL_RESERVE_EXCEPTION) )
+        constexpr void stat_shrink() noexcept
         {
-            for(auto i = capacity(); (capacity() < new_cap) && (i < new_cap); i++)
-            {
-                this->impl().add_node();
-            }
+            if constexpr(Flags & POOL_STATS)
+                this->m_shrinks++;
+        }
 
-            if constexpr(Flags & POOL_RESERVE_EXCEPTION)
-            {
-                if(capacity() < new_cap)
-                    throw std::bad_alloc();
-            }
+        //The counters are moved with the objects (the other pool is empty)
+        void stat_move(Pool_base& other) noexcept
+        {
+            if constexpr(Flags & POOL_STATS)
+                static_cast<Pool_counters&>(*this) = std::exchange(static_cast<Pool_counters&>(other), Pool_counters{});
         }
 
+        // Curiously Recurring Template interface
+        constexpr       Impl& impl()       { return *static_cast<      Impl*>(this); }
+        constexpr const Impl& impl() const { return *static_cast<const Impl*>(this); }
+};
 
-        // disable copy semantics
-        DPool_base(const DPool_base&)            = delete;
-        DPool_base& operator=(const DPool_base&) = delete;
 
-    protected:
-        std::size_t m_capacity = 0;
 
 
-        Impl& move_assign_operator(Impl&& other) noexcept
-        {
-            auto& self = this->impl();
 
-            if constexpr (Flags & POOL_SELF_MOVE_GUARD)
-            {
-                if(&self == &other)
-                    return self;
-            }
+/*
+ * The handle of object: the slot of node (low bits) and the generation
+ * of the slot (high bits). The default handle is null.
+ */
+template <typename U>
+struct Pool_handle
+{
+    using value_type = U;
 
-            self.dtor(); // Free the existing resource
-            self.move_from(std::move(other));
-            return self;
-        }
-};
+    U value{0};
 
+    explicit constexpr operator bool() const noexcept { return value != 0; }
 
+    friend constexpr bool operator==(Pool_handle a, Pool_handle b) noexcept { return a.value == b.value; }
+    friend constexpr bool operator!=(Pool_handle a, Pool_handle b) noexcept { return a.value != b.value; }
+};
 
 
 
-template <class AlgBase, class Impl>
-class Pool_node_allocator
+/*
+ * A mixin class that implements the handles of objects (slot map API)
+ *
+ *  Technical details:
+ *
+ *  Owner gives the slot of object (SLOT_BITS bits), the object of slot
+ *  and the generation of slot. The generation is incremented when the node
+ *  is taken from the free list and when it is returned to it, so it's odd
+ *  for the live objects (the handle is never null). The handle is valid only
+ *  if its generation equals the generation of slot, so the handles of the
+ *  destroyed objects are rejected (until the generation wraps around).
+ */
+template <typename     T,
+          Pool_flags_t Flags,
+          class        Impl,
+          class        Owner>
+class Pool_handles
 {
     public:
-        void shrink_to_fit(std::size_t new_cap = 0) noexcept
+        using handle_type = Pool_handle<pool_handle_value_t<Flags>>;
+
+        handle_type handle_of(const T* obj) noexcept
         {
-            new_cap = std::max(impl().size(), new_cap);
+            if(!obj)
+                return handle_type{};
 
-            for(auto i = impl().capacity(); (impl().capacity() > new_cap) && (i > new_cap); i--)
-            {
-                del_node();
-            }
-        }
+            const auto slot = pool().slot_of(obj);
 
+            return make_handle(slot, *pool().slot_gen(slot));
+        }
 
-    protected:
-        using Node = typename AlgBase::Node;
 
-        void add_node() noexcept
+        //Returns the object of handle, or nullptr if the handle is stale
+        T* get(handle_type handle) noexcept
         {
-            auto new_node = new(std::nothrow) Node();
-
-            if(new_node)
-            {
-                impl().add_to_free_nodes(new_node);
-                impl().m_capacity++;
-            }
-        }
+            const auto slot = std::size_t(handle.value & SLOT_MASK);
+            const auto gen  = pool().slot_gen(slot);
 
-        void del_node() noexcept
-        {
-            impl().m_capacity--;
-            auto top_node = impl().top_free_node();
-            impl().pop_free_node();
-            delete top_node;
-        }
+            //the generation of live object is odd
+            if(!gen || !(*gen & 1) || make_handle(slot, *gen) != handle)
+                return nullptr;
 
-        void dtor() noexcept
-        {
-            while(impl().top_free_node())
-                del_node();
+            return pool().slot_obj(slot);
         }
 
-        void move_from(Impl&&) noexcept  {}
 
     private:
-        constexpr Impl& impl() { return *static_cast<Impl*>(this); }
-};
+        using Value = typename handle_type::value_type;
 
+        static constexpr Value SLOT_MASK = (Value(1) << Owner::SLOT_BITS) - 1;
 
+        template <typename Gen>
+        static constexpr handle_type make_handle(std::size_t slot, Gen gen) noexcept
+        {
+            static_assert(Owner::SLOT_BITS + 4 <= 8 * sizeof(Value), "Too many slots for the handle, use POOL_HANDLES_64");
 
+            return handle_type{ Value(Value(gen) << Owner::SLOT_BITS | slot) };
+        }
 
-
-template <std::size_t  N, class AlgBase, class Impl>
-class Pool_block_allocator
-{
-    public:
-        void shrink_to_fit(std::size_t new_cap = 0) noexcept
-        {
-            if(!impl().empty())
-                return;
-
-            for(auto i = impl().capacity(); (impl().capacity() > new_cap) && (i > new_cap); i--)
-            {
-                del_node();
-            }
-
-            readd_blocks();
-        }
+        Impl& pool() noexcept { return static_cast<Impl&>(*this); }
+};
 
 
-    protected:
-        using Node = typename AlgBase::Node;
 
-        struct Block {
-            Block               *next;
-            std::array<Node, N>  nodes;
-        };
+struct Pool_no_handles {};
 
-        Block *m_blocks{nullptr};
 
 
-        void add_node() noexcept
-        {
-            auto new_block = new(std::nothrow) Block();
+template <std::size_t N>
+struct SPool_bump_index;
 
-            if(!new_block)
-                return;
 
-            impl().add_to_free_nodes(new_block->nodes);
+//The generations of the slots of static pool (index of node in m_pool).
+//The pools with the lazy free list (SPool_bump_index) set the generations of
+//the untouched nodes when they are handed out first (init_gens), so the ctor
+//stays O(1); the slots [m_bump, N) have no handles.
+template <typename     T,
+          std::size_t  N,
+          Pool_flags_t Flags,
+          class        Impl>
+class SPool_handles: public Pool_handles<T, Flags, Impl, SPool_handles<T, N, Flags, Impl>>
+{
+    protected:
+        static constexpr std::size_t SLOT_BITS = pool_bit_width(N - 1);
 
-            new_block->next = m_blocks;
-            m_blocks        = new_block;
+        std::array<pool_handle_gen_t<Flags>, N> m_gens;
 
-            impl().m_capacity += N;
+        SPool_handles() noexcept
+        {
+            if constexpr( !is_lazy() )
+                m_gens.fill(0);
         }
 
-        void del_node() noexcept
-        {
-            auto block = m_blocks;
-            m_blocks   = block->next;
+        static constexpr bool is_lazy() noexcept { return std::is_base_of_v<SPool_bump_index<N>, Impl>; }
 
-            impl().m_capacity -= N;
-            delete block;
+        void init_gens(std::size_t first, std::size_t cnt) noexcept
+        {
+            std::fill_n(&m_gens[first], cnt, 0);
         }
 
-        void readd_blocks() noexcept
+        template <class Node>
+        void bump_gen(const Node* node) noexcept
         {
-            impl().reset_free_nodes();
-            auto block = m_blocks;
-
-            while(block)
-            {
-                impl().add_to_free_nodes(block->nodes);
-                block = block->next;
-            }
+            m_gens[node - pool().m_pool.data()]++;
         }
 
-        void dtor() noexcept
+        std::size_t slot_of(const void* obj) noexcept
         {
-            while(m_blocks)
-                del_node();
+            auto &nodes = pool().m_pool;
+            return (static_cast<const std::byte*>(obj) - reinterpret_cast<const std::byte*>(nodes.data())) / sizeof(nodes[0]);
         }
 
-        void move_from(Impl&& other) noexcept
+        auto slot_gen(std::size_t slot) noexcept
         {
-            m_blocks       = other.m_blocks;
-            other.m_blocks = nullptr;
+            if constexpr(is_lazy())
+                return slot < pool().m_bump ? &m_gens[slot] : nullptr;
+            else
+                return slot < N ? &m_gens[slot] : nullptr;
         }
 
+        T* slot_obj(std::size_t slot) noexcept { return pool().get_obj(&pool().m_pool[slot]); }
+
+
     private:
-        constexpr Impl& impl() { return *static_cast<Impl*>(this); }
+        Impl& pool() noexcept { return static_cast<Impl&>(*this); }
+
+        friend Pool_handles<T, Flags, Impl, SPool_handles>;
 };
 
 
 
+template <typename     T,
+          Pool_flags_t Flags,
+          class        Impl,
+          class        Owner>
+using Pool_handles_base = std::conditional_t<pool_handles(Flags), Pool_handles<T, Flags, Impl, Owner>, Pool_no_handles>;
 
 
-/*
- * This is a minimal implementation of a circular doubly linked list.
- * Has limited methods and is not intended to be used as a complete class.
- */
-struct dlist_head
-{
-    public:
-        dlist_head *next;
-        dlist_head *prev;
 
-        //There is no constructor. We're gonna call init method when it's really necessary!
-        constexpr void init()        noexcept { prev = next = this;  }
-        constexpr bool empty() const noexcept { return next == this; }
 
-        void push_back(dlist_head *node) noexcept { insert(node, prev, this); }
 
+template <typename T>
+constexpr Pool_flags_t SPool_base_flags(Pool_flags_t Flags)
+{
+    return std::is_trivially_destructible_v<T> ? (Flags | POOL_DTOR_OFF) : Flags;
+}
 
-        /*
-         * move_to_back - deletes from current list and add to new_head
-         *
-         * new_head: the head that will follow our node
-         */
-        void move_to_back(dlist_head *new_head) noexcept
-        {
-            del_node(this);
-            new_head->push_back(this);
-        }
 
 
-        /*
-         * remove self from list.
-         * Note: empty() on node does not return true after this,
-         *       the node is in an undefined state.
-         */
-        void remove() noexcept { del_node(this); }
+template <typename     T,
+          std::size_t  N,
+          std::size_t  Align,
+          Pool_flags_t Flags,
+          class        Impl,
+          typename     Counter = std::size_t>
+class SPool_base: public Pool_base<T, N, Align, Flags, Impl, Counter>,
+                  public Pool_dtor<Impl, SPool_base_flags<T>(Flags)>,
+                  public std::conditional_t<pool_handles(Flags), SPool_handles<T, N, Flags, Impl>, Pool_no_handles>
+{
+    public:
+        SPool_base() = default;
 
+        static constexpr std::size_t capacity() noexcept { return N; }
 
-        /*
-         * splice_front - transfers all the elements of src
-         * into the this head (copy to front)
-         */
-        void splice_front(dlist_head *src) noexcept
-        {
-            if(!src->empty())
-            {
-                splice(src, this, next);
-                src->init();
-            }
-        }
+        //The memory of static pool is the pool itself
+        static constexpr std::size_t reserved_bytes() noexcept { return sizeof(Impl); }
 
+        constexpr std::size_t node_bytes() const noexcept { return sizeof(this->impl().m_pool[0]); }
 
-    private:
-        /*
-         * Insert a new node between two known consecutive nodes.
-         *
-         * This is only for internal list manipulation when
-         * we've already known both the prev/next nodes!
-         *
-         * before:  [prev] <-> [next]
-         * after:   [prev] <-> [node] <-> [next]
-         */
-        static void insert(dlist_head *node,
-                           dlist_head *prev,
-                           dlist_head *next) noexcept
-        {
-            next->prev = node;
-            node->next = next;
-            node->prev = prev;
-            prev->next = node;
-        }
+        // disable copy/move semantics
+        SPool_base(const SPool_base&)            = delete;
+        SPool_base(SPool_base&&)                 = delete;
+        SPool_base& operator=(const SPool_base&) = delete;
+        SPool_base& operator=(SPool_base&&)      = delete;
 
+    protected:
+        void dtor() noexcept { this->impl().destroy_all(); }
 
-        /*
-         * Delete a list node by making the prev/next nodes
-         * are pointing to each other
-         *
-         * This is only for internal list manipulation when
-         * we've already known both the prev/next nodes!
-         */
-        static void del(dlist_head *prev, dlist_head *next) noexcept
+        //The hooks of the algorithm: the node is taken from/returned to the free list
+        template <class Node>
+        void node_taken(const Node* node) noexcept
         {
-            next->prev = prev;
-            prev->next = next;
+            if constexpr(pool_handles(Flags))
+                this->bump_gen(node);
         }
 
-
-        /*
-         * Delete node from list.
-         *
-         * node: the element to delete from the list.
-         *
-         * Note: empty() on node does not return true after this,
-         *       the node is in an undefined state.
-         *
-         * before:  [prev] <-> [node] <-> [next]
-         * after:   [prev] <-> [next];              old_val <- [node] -> old_val
-         */
-        static void del_node(dlist_head *node) noexcept
+        template <class Node>
+        void node_freed(const Node* node) noexcept
         {
-            del(node->prev, node->next);
+            if constexpr(pool_handles(Flags))
+                this->bump_gen(node);
         }
 
-
-        static void splice(dlist_head *list,
-                           dlist_head *prev,
-                           dlist_head *next) noexcept
-        {
-            dlist_head *first = list->next;
-            dlist_head *last  = list->prev;
-
-            first->prev = prev;
-            prev->next  = first;
-
-            last->next = next;
-            next->prev = last;
-        }
+        friend Pool_dtor<Impl, SPool_base_flags<T>(Flags)>;
 };
 
 
 
 
 
-/*
- * A mixin class that implements a node management algorithm
- * based on a circular doubly-linked list
- *
- *  Technical details:
- *
- *  Each Node is a struct of a dlist_head and a type T.
- *  Creation and Destroying is very fast - as it is a simple replacement
- *  of pointers in a circular doubly-linked list.
- */
 template <typename     T,
           std::size_t  N,
           std::size_t  Align,
           Pool_flags_t Flags,
-          class        Impl>
-class Pool_dlist_base
+          class        Impl,
+          typename     Counter = std::size_t>
+class DPool_base: public Pool_base<T, N, Align, Flags, Impl, Counter>,
+                  public Pool_dtor<Impl, Flags>
 {
     public:
-        Pool_dlist_base() noexcept
-        {
-            m_used_nodes.init();
-        }
+        DPool_base() = default;
 
+        constexpr std::size_t capacity() const noexcept { return m_capacity; }
 
-        template <typename UnaryFunction>
-        void for_each(UnaryFunction f)
+        template <typename... Args>
+        T* create(Args&&... args) noexcept(is_nothrow_create<T, Args...>)
         {
-            auto iter = m_used_nodes.next;
-
-            while(iter != &m_used_nodes)
+            //The concurrent algorithms add new nodes themselves in create_obj,
+            //the check full() + add_node() is not atomic for them.
+            if constexpr ( !(Flags & POOL_FIXED_CAPACITY) && !is_atomic_counter<Counter> )
             {
-                auto next_iter = iter->next; //guard if user will delete obj(for current iter) from pool
-                f((T *)get_data(iter));
-                iter = next_iter;
+                if(this->full())
+                    this->impl().add_node();
             }
+
+            auto obj = this->impl().create_obj(std::forward<Args>(args)...);
+            this->stat_create(obj != nullptr);
+            POOL_PROBE(create, &this->impl(), obj, this->size());
+            return obj;
         }
 
 
-        void destroy(const T* obj) noexcept
+        template <typename... Args>
+        std::size_t create_n(T** objs, std::size_t n, const Args&... args)
+            noexcept(is_nothrow_create<T, const Args&...>)
         {
-            if(obj)
-                destroy_obj(obj);
-        }
+            auto cnt = this->impl().create_n_obj(objs, n, args...);
 
+            if constexpr ( !(Flags & POOL_FIXED_CAPACITY) && !is_atomic_counter<Counter> )
+            {
+                if(cnt < n)
+                    cnt = this->impl().create_n_grow(objs, cnt, n, args...);
+            }
 
-        void destroy_all() noexcept
-        {
-            for_each([this](T* obj){ this->impl().destroy_obj(obj); });
+            this->stat_create(cnt);
+            POOL_PROBE(create_n, &this->impl(), cnt, this->size());
+            return cnt;
         }
 
 
-        template <class Value>
-        class Iterator_t: public Iterator_facade<Iterator_t<Value>, Value>
+        void reserve(std::size_t new_cap) noexcept( !(Flags & POOL_RESERVE_EXCEPTION) )
         {
-            public:
-                explicit Iterator_t(const dlist_head *node = nullptr) noexcept:
-                    m_node(const_cast<dlist_head *>(node)) {}
+            for(auto i = capacity(); (capacity() < new_cap) && (i < new_cap); i++)
+            {
+                this->impl().add_node();
+            }
 
-                template <class OtherValue>
-                Iterator_t(const Iterator_t<OtherValue> &other) noexcept:
-                    m_node(other.m_node) {}
+            if constexpr(Flags & POOL_RESERVE_EXCEPTION)
+            {
+                if(capacity() < new_cap)
+                    throw std::bad_alloc();
+            }
+        }
 
-            private:
-                dlist_head *m_node;
 
-                template <class OtherValue>
-                bool equal(const Iterator_t<OtherValue> &other) const noexcept
-                {
-                    return m_node == other.m_node;
-                }
+        // disable copy semantics
+        DPool_base(const DPool_base&)            = delete;
+        DPool_base& operator=(const DPool_base&) = delete;
 
-                void increment() noexcept { m_node = m_node->next; }
-                void decrement() noexcept { m_node = m_node->prev; }
-                Value& dereference() const noexcept
-                {
-                    auto data = (Value *)Pool_dlist_base::get_data(m_node);
-                    return *data;
-                }
+    protected:
+        Counter m_capacity{0};
 
-                template <class> friend class Iterator_t;
-                friend class Iterator_facade<Iterator_t, Value>;
-                friend class Pool_dlist_base;
-        };
 
-        using iterator               = Iterator_t<T>;
-        using const_iterator         = Iterator_t<const T>;
-        using reverse_iterator       = std::reverse_iterator<iterator>;
-        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+        Impl& move_assign_operator(Impl&& other) noexcept
+        {
+            auto& self = this->impl();
 
-        constexpr auto begin() noexcept       { return iterator(m_used_nodes.next); }
-        constexpr auto end()   noexcept       { return iterator(&m_used_nodes    ); }
+            if constexpr (Flags & POOL_SELF_MOVE_GUARD)
+            {
+                if(&self == &other)
+                    return self;
+            }
+
+            self.dtor(); // Free the existing resource
+            self.move_from(std::move(other));
+            return self;
+        }
+};
+
+
+
+
+
+/*
+ * The memory sources of the dynamic pools (template parameter Source).
+ *
+ * The source gives memory for the nodes (Pool_node_allocator) and
+ * the blocks (Pool_block_allocator):
+ *
+ * void* allocate(std::size_t bytes, std::size_t align) noexcept; //nullptr if no memory
+ * void  deallocate(void* p, std::size_t bytes, std::size_t align) noexcept;
+ *
+ * The source is a base of the allocator, so the stateless source costs nothing.
+ */
+struct Pool_heap_source
+{
+    static void* allocate(std::size_t bytes, std::size_t align) noexcept
+    {
+        if(align > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            return ::operator new(bytes, std::align_val_t(align), std::nothrow);
+
+        return ::operator new(bytes, std::nothrow);
+    }
+
+    static void deallocate(void* p, std::size_t, std::size_t align) noexcept
+    {
+        if(align > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            ::operator delete(p, std::align_val_t(align));
+        else
+            ::operator delete(p);
+    }
+};
+
+
+
+/*
+ * The memory source which carves memory from the user-supplied buffer
+ * (an arena, a DMA-able buffer, a region from the framework): there are
+ * no heap calls. The buffer must outlive the pool.
+ *
+ * Technical details:
+ *
+ * It's a bump allocator: deallocate() gives memory back only for the last
+ * allocated piece (LIFO). The blocks of Pool_xxx_block are released in LIFO
+ * order (shrink_to_fit of empty pool returns the whole buffer), the nodes of
+ * Pool_xxx are released in the order of the free list.
+ */
+class Pool_buffer_source
+{
+    public:
+        Pool_buffer_source() noexcept = default; //no memory
+
+        Pool_buffer_source(void* buf, std::size_t size) noexcept:
+            m_begin(static_cast<std::byte*>(buf)),
+            m_cur(m_begin),
+            m_end(m_begin + size)
+        {}
+
+        void* allocate(std::size_t bytes, std::size_t align) noexcept
+        {
+            auto cur     = reinterpret_cast<std::uintptr_t>(m_cur);
+            auto aligned = (cur + align - 1) & ~(std::uintptr_t)(align - 1);
+
+            if(aligned < cur || aligned + bytes > reinterpret_cast<std::uintptr_t>(m_end))
+                return nullptr;
+
+            m_cur = m_cur + (aligned - cur) + bytes;
+
+            return m_cur - bytes;
+        }
+
+        void deallocate(void* p, std::size_t bytes, std::size_t) noexcept
+        {
+            if(static_cast<std::byte*>(p) + bytes == m_cur)
+                m_cur = static_cast<std::byte*>(p);
+        }
+
+        std::size_t used()      const noexcept { return m_cur - m_begin; }
+        std::size_t available() const noexcept { return m_end - m_cur;   }
+
+
+    private:
+        std::byte *m_begin = nullptr;
+        std::byte *m_cur   = nullptr;
+        std::byte *m_end   = nullptr;
+};
+
+
+
+
+
+template <class AlgBase, class Impl, class Source>
+class Pool_node_allocator: protected Source
+{
+    public:
+        using source_type = Source;
+
+        Pool_node_allocator() = default;
+
+        explicit Pool_node_allocator(const Source& source) noexcept: Source(source) {}
+
+        Source&       source()       noexcept { return *this; }
+        const Source& source() const noexcept { return *this; }
+
+
+        void shrink_to_fit(std::size_t new_cap = 0) noexcept
+        {
+            new_cap = std::max(impl().size(), new_cap);
+
+            for(auto i = impl().capacity(); (impl().capacity() > new_cap) && (i > new_cap); i--)
+            {
+                del_node();
+            }
+        }
+
+
+        //The memory of nodes (see Pool_stats)
+        std::size_t reserved_bytes() const noexcept { return impl().capacity() * sizeof(Node); }
+
+        static constexpr std::size_t node_bytes() noexcept { return sizeof(Node); }
+
+
+    protected:
+        using Node = typename AlgBase::Node;
+
+        constexpr void node_taken(Node*) noexcept {}
+        constexpr void node_freed(Node*) noexcept {}
+
+        void add_node() noexcept
+        {
+            auto p = source().allocate(sizeof(Node), alignof(Node));
+
+            if(p)
+            {
+                impl().add_to_free_nodes(::new (p) Node);
+                impl().m_capacity++;
+            }
+
+            impl().stat_grow(p != nullptr);
+            POOL_PROBE(grow, &impl(), p, impl().capacity());
+        }
+
+        //add nodes and create objects objs[cnt..n) in them, objs[0..cnt) are
+        //created already. Returns the count of all created objects.
+        template <typename T, typename... Args>
+        std::size_t create_n_grow(T** objs, std::size_t cnt, std::size_t n, const Args&... args)
+        {
+            create_n_rollback<T, AlgBase> saver{impl(), objs, cnt};
+
+            for(std::size_t i = cnt; i < n; i++)
+                add_node();
+
+            cnt += impl().create_n_obj(objs + cnt, n - cnt, args...);
+            saver.cnt = 0;
+            return cnt;
+        }
+
+        void del_node() noexcept
+        {
+            impl().m_capacity--;
+            auto top_node = impl().top_free_node();
+            impl().pop_free_node();
+
+            std::destroy_at(top_node);
+            source().deallocate(top_node, sizeof(Node), alignof(Node));
+            impl().stat_shrink();
+            POOL_PROBE(shrink, &impl(), top_node, impl().capacity());
+        }
+
+        void dtor() noexcept
+        {
+            while(impl().top_free_node())
+                del_node();
+        }
+
+        //The nodes belong to the source, so the source goes with them
+        void move_from(Impl&& other) noexcept
+        {
+            std::swap(source(), other.source());
+        }
+
+    private:
+        constexpr       Impl& impl()       { return *static_cast<      Impl*>(this); }
+        constexpr const Impl& impl() const { return *static_cast<const Impl*>(this); }
+};
+
+
+
+
+
+#if defined(POOL_MMAP)
+/*
+ * Anonymous memory for the blocks (flag POOL_MMAP_BLOCKS).
+ *
+ * The huge pages are tried only for the blocks >= 2 MiB (the length is
+ * rounded up to 2 MiB): at first MAP_HUGETLB (needs the reserved huge pages),
+ * then the ordinary pages + madvise(MADV_HUGEPAGE) (transparent huge pages).
+ * The smaller blocks are mapped on the ordinary pages.
+ * The length is calculated in the same way in mmap_alloc and mmap_free.
+ */
+inline constexpr std::size_t POOL_HUGE_PAGE_SIZE = std::size_t(2) << 20;
+
+inline std::size_t mmap_length(std::size_t size) noexcept
+{
+    const std::size_t page = size >= POOL_HUGE_PAGE_SIZE ? POOL_HUGE_PAGE_SIZE
+                                                         : (std::size_t)sysconf(_SC_PAGESIZE);
+
+    return (size + page - 1) / page * page;
+}
+
+
+//align (power of two) > page: the memory is mapped with a reserve and the excess is unmapped
+inline void* mmap_alloc(std::size_t size, std::size_t align = 0) noexcept
+{
+    const auto length = mmap_length(size);
+    void*      p      = MAP_FAILED;
+
+#if defined(MAP_HUGETLB)
+    if(length >= POOL_HUGE_PAGE_SIZE && align <= POOL_HUGE_PAGE_SIZE)
+        p = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+
+    if(p == MAP_FAILED)
+    {
+        const std::size_t page  = sysconf(_SC_PAGESIZE);
+        const std::size_t extra = align > page ? align - page : 0;
+
+        p = mmap(nullptr, length + extra, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if(p == MAP_FAILED)
+            return nullptr;
+
+        if(extra)
+        {
+            const auto addr    = reinterpret_cast<std::uintptr_t>(p);
+            const auto aligned = (addr + align - 1) & ~(std::uintptr_t)(align - 1);
+
+            if(aligned != addr)
+                munmap(p, aligned - addr);
+
+            if(addr + extra != aligned)
+                munmap(reinterpret_cast<void*>(aligned + length), addr + extra - aligned);
+
+            p = reinterpret_cast<void*>(aligned);
+        }
+
+    #if defined(MADV_HUGEPAGE)
+        if(length >= POOL_HUGE_PAGE_SIZE)
+            madvise(p, length, MADV_HUGEPAGE); //it's only a hint, the error is not important
+    #endif
+    }
+
+    return p;
+}
+
+
+inline void mmap_free(void* p, std::size_t size) noexcept
+{
+    munmap(p, mmap_length(size));
+}
+#endif // POOL_MMAP
+
+
+
+
+
+template <typename     T,
+          std::size_t  N,
+          std::size_t  Align,
+          Pool_flags_t Flags,
+          class        Impl>
+class Pool_dlist_base;
+
+template <class Node>
+union Pool_dlist_link;
+
+template <class AlgBase>
+inline constexpr bool is_dlist_base = false;
+
+template <typename T, std::size_t N, std::size_t Align, Pool_flags_t Flags, class Impl>
+inline constexpr bool is_dlist_base<Pool_dlist_base<T, N, Align, Flags, Impl>> = true;
+
+
+
+template <std::size_t  N, Pool_flags_t Flags, class AlgBase, class Impl, class Source>
+class Pool_block_allocator: protected Source
+{
+    public:
+        using source_type = Source;
+
+        Pool_block_allocator() = default;
+
+        explicit Pool_block_allocator(const Source& source) noexcept: Source(source) {}
+
+        Source&       source()       noexcept { return *this; }
+        const Source& source() const noexcept { return *this; }
+
+
+        //POOL_TRIM_BLOCKS/POOL_FULLEST_BLOCK: the empty blocks are released while the pool
+        //isn't empty, else the blocks are released only if the pool is empty.
+        void shrink_to_fit(std::size_t new_cap = 0) noexcept
+        {
+            if constexpr(TRACK)
+            {
+                trim_blocks(new_cap);
+                return;
+            }
+
+            if(!impl().empty())
+                return;
+
+            while(m_blocks && (impl().capacity() > new_cap))
+            {
+                del_node();
+            }
+
+            readd_blocks();
+        }
+
+
+        //The empty blocks are released automatically
+        //when there are more than max_empty of them (0 - off, by default)
+        void trim_threshold(std::size_t max_empty) noexcept
+        {
+            static_assert(TRACK, "trim_threshold needs the flag POOL_TRIM_BLOCKS or POOL_FULLEST_BLOCK");
+            m_state.trim_threshold = max_empty;
+        }
+
+        std::size_t empty_blocks() const noexcept
+        {
+            static_assert(TRACK, "empty_blocks needs the flag POOL_TRIM_BLOCKS or POOL_FULLEST_BLOCK");
+            return m_state.empty_blocks;
+        }
+
+
+        //Moves the live objects to the lowest blocks (by address) which can hold them
+        //and releases the other blocks (Pool_dlist_block). The objects are moved by
+        //the move constructor, relocate(old, new) is called for each moved object
+        //before the old one is destroyed. The order of objects (iteration) is kept.
+        //Returns the count of moved objects.
+        template <typename RelocateFunction>
+        std::size_t compact(RelocateFunction relocate) noexcept
+        {
+            using T = typename Impl::value_type;
+
+            static_assert(TRACK, "compact needs the flag POOL_TRIM_BLOCKS or POOL_FULLEST_BLOCK");
+            static_assert(is_dlist_base<AlgBase>, "compact needs the list of live objects (Pool_dlist_block)");
+            static_assert(std::is_nothrow_move_constructible_v<T>, "compact needs the noexcept move constructor");
+
+            const auto limit = compact_limit();
+
+            //the free nodes of the blocks above limit leave the free lists
+            park_cur_block();
+
+            for(auto block = m_blocks; block; block = block->next)
+            {
+                if(above(block, limit))
+                    bucket_remove(block);
+            }
+
+            next_cur_block();
+
+            std::size_t cnt = 0;
+
+            impl().for_each([&](T* obj)
+            {
+                if(above(block_of(AlgBase::get_node(obj)), limit))
+                {
+                    impl().relocate_obj(obj, relocate);
+                    cnt++;
+                }
+            });
+
+            //the nodes of the blocks above limit are out of the lists and without objects
+            for(auto block = m_blocks; block; )
+            {
+                auto next = block->next;
+
+                if(above(block, limit))
+                {
+                    if(!block->live)
+                        m_state.empty_blocks--;
+
+                    unlink_block(block);
+                    impl().m_capacity -= block->size;
+                    free_block(block);
+                }
+
+                block = next;
+            }
+
+            return cnt;
+        }
+
+        std::size_t compact() noexcept
+        {
+            return compact([](auto*, auto*){});
+        }
+
+
+        //The memory of blocks (see Pool_stats)
+        std::size_t reserved_bytes() const noexcept
+        {
+            std::size_t bytes = 0;
+
+            for(auto block = m_blocks; block; block = block->next)
+                bytes += block_bytes(block->size);
+
+            if constexpr(HANDLES)
+                bytes += m_state.count * sizeof(Block_slot);
+
+            return bytes;
+        }
+
+        static constexpr std::size_t node_bytes() noexcept { return NODE_BYTES; }
+
+
+    protected:
+        using Node = typename AlgBase::Node;
+
+        static constexpr bool TRIM    = Flags & POOL_TRIM_BLOCKS;
+        static constexpr bool FULLEST = Flags & POOL_FULLEST_BLOCK;
+        static constexpr bool TRACK   = TRIM || FULLEST; //the blocks count their live nodes
+        static constexpr bool HANDLES = pool_handles(Flags);
+        static constexpr bool SPLIT   = (Flags & POOL_SPLIT_NODES) && is_dlist_base<AlgBase>;
+        static constexpr bool FIND    = TRACK || HANDLES || SPLIT; //the block of node is found by the address of node
+
+        //HANDLES: the generations of nodes are placed right after the nodes of block
+        //(SPLIT: after the links of nodes, they are placed right after the nodes)
+        using gen_type = pool_handle_gen_t<Flags>;
+        using Link     = Pool_dlist_link<Node>;
+
+        static constexpr std::size_t NODE_BYTES = sizeof(Node) + (SPLIT   ? sizeof(Link)     : 0)
+                                                               + (HANDLES ? sizeof(gen_type) : 0);
+
+        //SPLIT: the links are aligned after the nodes
+        static constexpr std::size_t LINKS_PAD  = SPLIT ? alignof(Link) - 1 : 0;
+
+        //0 - empty blocks, 1..7 - by occupancy (POOL_TRIM_BLOCKS: 1 - all non-empty blocks)
+        static constexpr std::size_t BUCKETS   = FULLEST ? 8 : 2;
+        static constexpr std::size_t NO_BUCKET = BUCKETS; //full or current block
+
+        struct Block;
+
+        //TRACK: the own free list of block, the links of its bucket
+        //and the previous block in the list of blocks
+        struct Block_bucket {
+            Node        *free_nodes;
+            Block       *bucket_prev;
+            Block       *bucket_next;
+            std::size_t  bucket;
+            Block       *prev;
+        };
+
+        struct Block_no_bucket {};
+
+        //HANDLES: the index of block in the table of blocks
+        struct Block_id {
+            std::size_t  id;
+        };
+
+        struct Block_no_id {};
+
+        //The header of block, the nodes are placed right after it
+        struct Block: std::conditional_t<TRACK,   Block_bucket, Block_no_bucket>,
+                      std::conditional_t<HANDLES, Block_id,     Block_no_id> {
+            Block       *next;
+            std::size_t  size; //count of nodes
+            std::size_t  live; //count of nodes out of the free lists (TRACK)
+
+            Node* nodes() noexcept
+            {
+                return std::launder(reinterpret_cast<Node*>(reinterpret_cast<std::byte*>(this) + NODES_OFFSET));
+            }
+
+            Link* links() noexcept
+            {
+                return std::launder(reinterpret_cast<Link*>(reinterpret_cast<std::byte*>(this) + links_offset(size)));
+            }
+
+            gen_type* gens() noexcept
+            {
+                return reinterpret_cast<gen_type*>(reinterpret_cast<std::byte*>(this) + gens_offset(size));
+            }
+        };
+
+        static constexpr std::size_t NODES_OFFSET = (sizeof(Block) + alignof(Node) - 1) / alignof(Node) * alignof(Node);
+
+        static constexpr std::size_t links_offset(std::size_t size) noexcept
+        {
+            return (NODES_OFFSET + size * sizeof(Node) + LINKS_PAD) / alignof(Link) * alignof(Link);
+        }
+
+        static constexpr std::size_t gens_offset(std::size_t size) noexcept
+        {
+            return SPLIT ? links_offset(size) + size * sizeof(Link) : NODES_OFFSET + size * sizeof(Node);
+        }
+
+        static constexpr std::size_t block_bytes(std::size_t size) noexcept
+        {
+            return gens_offset(size) + (HANDLES ? size * sizeof(gen_type) : 0);
+        }
+
+
+        //POOL_GROW_BLOCKS: the block size doubles from N up to MAX_BLOCK_SIZE nodes
+        static constexpr std::size_t max_block_size() noexcept
+        {
+            if constexpr( !(Flags & POOL_GROW_BLOCKS) )
+            {
+                return N;
+            }
+            else
+            {
+                constexpr std::size_t log2 = (Flags & POOL_GROW_LIMIT_MASK) >> POOL_GROW_LIMIT_SHIFT;
+
+                constexpr std::size_t bytes = (Flags & POOL_GROW_LIMIT_BYTES) ? std::size_t(1) << log2 :
+                                              log2                            ? 0 : POOL_GROW_BLOCK_SIZE;
+
+                constexpr std::size_t head  = NODES_OFFSET + LINKS_PAD;
+                constexpr std::size_t limit = !bytes       ? std::size_t(1) << log2 :
+                                              bytes > head ? (bytes - head) / NODE_BYTES : 0;
+
+                return std::max(limit, N);
+            }
+        }
+
+        static constexpr std::size_t MAX_BLOCK_SIZE = max_block_size();
+
+
+        //FIND, the block of node is found:
+        //  MASK   - all blocks have N nodes, each one is aligned to its span (its size rounded
+        //           up to a power of two), so the mask of node is the address of block.
+        //  SORTED - POOL_GROW_BLOCKS, the blocks of different sizes aren't aligned (a common
+        //           span would be the span of the biggest block), the block of node is found
+        //           by the binary search in the table of blocks sorted by address.
+        static constexpr bool MASK   = FIND && MAX_BLOCK_SIZE == N;
+        static constexpr bool SORTED = FIND && !MASK;
+
+        static constexpr std::size_t span_of(std::size_t bytes) noexcept
+        {
+            std::size_t span = 1;
+            while(span < bytes) span <<= 1;
+            return span;
+        }
+
+        static constexpr std::size_t BLOCK_SPAN  = MASK ? span_of(block_bytes(N)) : 0;
+        static constexpr std::size_t BLOCK_ALIGN = MASK ? BLOCK_SPAN : std::max(alignof(Block), alignof(Node));
+
+        //The block of node (or of link)
+        Block* block_of(const void* node) const noexcept
+        {
+            const auto addr = reinterpret_cast<std::uintptr_t>(node);
+
+            if constexpr(MASK)
+            {
+                return reinterpret_cast<Block*>(addr & ~(std::uintptr_t)(BLOCK_SPAN - 1));
+            }
+            else
+            {
+                auto first = m_state.sorted;
+                auto last  = first + m_state.sorted_count;
+
+                //the last block which starts not above the node
+                return *(std::upper_bound(first, last, addr, [](std::uintptr_t addr, const Block* block) {
+                    return addr < reinterpret_cast<std::uintptr_t>(block);
+                }) - 1);
+            }
+        }
+
+        //SPLIT: the link of node has the same index in the links of block
+        Link* split_link(Node* node) noexcept
+        {
+            auto block = block_of(node);
+            return &block->links()[node - block->nodes()];
+        }
+
+        Node* split_node(Link* link) noexcept
+        {
+            auto block = block_of(link);
+            return &block->nodes()[link - block->links()];
+        }
+
+        //The next free node
+        Node*& next_of(Node* node) noexcept
+        {
+            if constexpr(SPLIT)
+                return split_link(node)->next;
+            else
+                return node->next;
+        }
+
+
+        //HANDLES: the slot is the id of block (high bits) and the offset of node in the block,
+        //the rest bits of handle are split between the generation and the id
+        static constexpr std::size_t OFFSET_BITS = pool_bit_width(MAX_BLOCK_SIZE - 1);
+        static constexpr std::size_t OFFSET_MASK = (std::size_t(1) << OFFSET_BITS) - 1;
+        static constexpr std::size_t HANDLE_BITS = 8 * sizeof(pool_handle_value_t<Flags>);
+
+        static_assert(!HANDLES || OFFSET_BITS + 8 <= HANDLE_BITS, "The block is too big for the handle, use POOL_HANDLES_64");
+
+        static constexpr std::size_t GEN_BITS  = HANDLES ? std::min((HANDLE_BITS - OFFSET_BITS + 1) / 2, 8 * sizeof(gen_type)) : 0;
+        static constexpr std::size_t SLOT_BITS = HANDLE_BITS - GEN_BITS;
+        static constexpr std::size_t MAX_IDS   = HANDLES ? std::size_t(1) << (SLOT_BITS - OFFSET_BITS) : 0;
+
+        gen_type& gen_of(const Node* node) noexcept
+        {
+            auto block = block_of(node);
+            return block->gens()[node - block->nodes()];
+        }
+
+
+        //TRACK: the free list of algorithm contains only the free nodes of the current block,
+        //the free nodes of other blocks are in their own lists. The blocks (except current
+        //and full) are in the buckets by occupancy, mask - the non-empty buckets. The bucket 0
+        //is the list of empty blocks, so they are released one by one without walks.
+        //The free list of algorithm is empty only if there are no free nodes at all.
+        struct Trim_state {
+            std::size_t                  empty_blocks   = 0; //count of blocks with live == 0
+            std::size_t                  trim_threshold = 0;
+            Block                       *cur = nullptr;
+            std::array<Block*, BUCKETS>  buckets{};
+            std::uint64_t                mask = 0;
+        };
+
+        struct No_state {};
+
+        struct Block_slot {
+            Block    *block;
+            gen_type  seed; //the first generation of the nodes of new block with this id
+        };
+
+        //HANDLES: the table of blocks by id
+        struct Handle_state {
+            Block_slot  *slots = nullptr;
+            std::size_t  count = 0;
+        };
+
+        struct No_handle_state {};
+
+        //SORTED: the table of blocks sorted by address
+        struct Sorted_state {
+            Block       **sorted       = nullptr;
+            std::size_t   sorted_count = 0;
+            std::size_t   sorted_cap   = 0;
+        };
+
+        struct No_sorted_state {};
+
+        struct State: std::conditional_t<TRACK,   Trim_state,   No_state>,
+                      std::conditional_t<HANDLES, Handle_state, No_handle_state>,
+                      std::conditional_t<SORTED,  Sorted_state, No_sorted_state> {};
+
+
+        Block *m_blocks{nullptr};
+        State  m_state;
+
+
+        //The hooks of the algorithm: the node is taken from/returned to the free list
+        void node_taken(Node* node) noexcept
+        {
+            if constexpr(HANDLES)
+                gen_of(node)++;
+
+            if constexpr(TRACK)
+            {
+                if(block_of(node)->live++ == 0)
+                    m_state.empty_blocks--;
+
+                if(!impl().m_free_nodes) //the current block is full
+                    next_cur_block();
+            }
+        }
+
+        void node_freed(Node* node) noexcept
+        {
+            if constexpr(HANDLES)
+                gen_of(node)++;
+
+            if constexpr(TRACK)
+            {
+                auto block = block_of(node);
+                block->live--;
+
+                if(!m_state.cur)
+                {
+                    m_state.cur = block; //it's the only free node
+                }
+                else if(block != m_state.cur)
+                {
+                    //the node is on top of the free list, it goes to the own list of block
+                    impl().m_free_nodes = next_of(node);
+                    next_of(node)       = block->free_nodes;
+                    block->free_nodes   = node;
+
+                    if(bucket_of(block) != block->bucket)
+                    {
+                        bucket_remove(block);
+                        bucket_insert(block);
+                    }
+                }
+
+                if(block->live == 0)
+                {
+                    m_state.empty_blocks++;
+
+                    if(m_state.trim_threshold)
+                        trim_empty_blocks();
+                }
+            }
+        }
+
+
+        static std::size_t bucket_of(const Block* block) noexcept
+        {
+            if(block->live == block->size)
+                return NO_BUCKET;
+
+            return block->live ? 1 + block->live * (BUCKETS - 1) / block->size : 0;
+        }
+
+        void bucket_insert(Block* block) noexcept
+        {
+            block->bucket = bucket_of(block);
+
+            if(block->bucket == NO_BUCKET)
+                return;
+
+            auto &head         = m_state.buckets[block->bucket];
+            block->bucket_prev = nullptr;
+            block->bucket_next = head;
+
+            if(head)
+                head->bucket_prev = block;
+
+            head          = block;
+            m_state.mask |= std::uint64_t(1) << block->bucket;
+        }
+
+        void bucket_remove(Block* block) noexcept
+        {
+            if(block->bucket == NO_BUCKET)
+                return;
+
+            if(block->bucket_next)
+                block->bucket_next->bucket_prev = block->bucket_prev;
+
+            if(block->bucket_prev)
+            {
+                block->bucket_prev->bucket_next = block->bucket_next;
+            }
+            else
+            {
+                m_state.buckets[block->bucket] = block->bucket_next;
+
+                if(!block->bucket_next)
+                    m_state.mask &= ~(std::uint64_t(1) << block->bucket);
+            }
+
+            block->bucket = NO_BUCKET;
+        }
+
+        //The current block is full (or parked): the fullest block becomes current
+        void next_cur_block() noexcept
+        {
+            m_state.cur = nullptr;
+
+            if(!m_state.mask)
+                return;
+
+            auto block = m_state.buckets[63 - clz64(m_state.mask)];
+            bucket_remove(block);
+
+            impl().m_free_nodes = block->free_nodes;
+            block->free_nodes   = nullptr;
+            m_state.cur         = block;
+        }
+
+        //The free nodes of the current block go back to its own list
+        void park_cur_block() noexcept
+        {
+            if(auto block = m_state.cur)
+            {
+                block->free_nodes   = impl().m_free_nodes;
+                impl().m_free_nodes = nullptr;
+                m_state.cur         = nullptr;
+
+                bucket_insert(block);
+            }
+        }
+
+
+        //The next block is twice as big as the last one (POOL_GROW_BLOCKS)
+        std::size_t next_block_size() const noexcept
+        {
+            if constexpr(MAX_BLOCK_SIZE == N)
+                return N;
+
+            if(!m_blocks)
+                return N;
+
+            return m_blocks->size < MAX_BLOCK_SIZE / 2 ? m_blocks->size * 2 : MAX_BLOCK_SIZE;
+        }
+
+        Block* new_block() noexcept
+        {
+            const auto  size = next_block_size();
+            std::size_t id   = 0;
+            bool        ok   = true;
+
+            if constexpr(HANDLES)
+            {
+                id = acquire_id();
+                ok = id != MAX_IDS;
+            }
+
+            if constexpr(SORTED)
+                ok = ok && reserve_sorted();
+
+            if(!ok)
+            {
+                impl().stat_grow(false);
+                POOL_PROBE(grow, &impl(), (void*)nullptr, impl().capacity());
+                return nullptr;
+            }
+
+            auto block = alloc_block(size);
+            impl().stat_grow(block != nullptr);
+
+            if(block)
+            {
+                if constexpr(HANDLES)
+                {
+                    block->id                = id;
+                    m_state.slots[id].block = block;
+                    std::uninitialized_fill_n(block->gens(), size, m_state.slots[id].seed);
+                }
+
+                if constexpr(SORTED)
+                    insert_sorted(block);
+
+                link_block(block);
+                impl().m_capacity += size;
+            }
+
+            POOL_PROBE(grow, &impl(), block, impl().capacity());
+            return block;
+        }
+
+        void add_node() noexcept
+        {
+            if(auto block = new_block())
+                add_free_block(block);
+        }
+
+        //All nodes of the block go to the free list (without the hooks)
+        void add_free_block(Block* block) noexcept
+        {
+            if constexpr(TRACK)
+            {
+                block->live = 0;
+                m_state.empty_blocks++;
+
+                if(m_state.cur) //the nodes go to the own list of block
+                {
+                    auto nodes = block->nodes();
+
+                    for(std::size_t i = 0; i < block->size; i++)
+                    {
+                        next_of(&nodes[i]) = block->free_nodes;
+                        block->free_nodes  = &nodes[i];
+                    }
+
+                    bucket_insert(block);
+                    return;
+                }
+
+                m_state.cur = block;
+            }
+
+            impl().add_to_free_nodes(block->nodes(), block->size);
+        }
+
+        //The free list is empty, so the whole blocks are handed out
+        //in one step (without threading of nodes to the free list).
+        //objs[0..cnt) are created already, returns the count of all created objects.
+        template <typename T, typename... Args>
+        std::size_t create_n_grow(T** objs, std::size_t cnt, std::size_t n, const Args&... args)
+        {
+            create_n_rollback<T, AlgBase> saver{impl(), objs};
+
+            while(cnt < n)
+            {
+                saver.cnt  = cnt;
+                auto block = new_block();
+
+                if(!block)
+                    break;
+
+                if(n - cnt >= block->size)
+                {
+                    if constexpr(HANDLES) //the nodes are taken without the hooks
+                    {
+                        auto gens = block->gens();
+
+                        for(std::size_t i = 0; i < block->size; i++)
+                            gens[i]++;
+                    }
+
+                    impl().create_n_nodes(block->nodes(), block->size, objs + cnt, args...);
+                    cnt += block->size;
+                }
+                else
+                {
+                    add_free_block(block);
+                    cnt += impl().create_n_obj(objs + cnt, n - cnt, args...);
+                }
+            }
+
+            saver.cnt = 0;
+            return cnt;
+        }
+
+        void del_node() noexcept
+        {
+            auto block = m_blocks;
+            unlink_block(block);
+
+            impl().m_capacity -= block->size;
+            free_block(block);
+        }
+
+        //The new block is the head of the list of blocks
+        void link_block(Block* block) noexcept
+        {
+            block->next = m_blocks;
+
+            if constexpr(TRACK)
+            {
+                block->prev = nullptr;
+
+                if(m_blocks)
+                    m_blocks->prev = block;
+            }
+
+            m_blocks = block;
+        }
+
+        //O(1) for TRACK, else only the head can be unlinked
+        void unlink_block(Block* block) noexcept
+        {
+            if constexpr(TRACK)
+            {
+                if(block->next)
+                    block->next->prev = block->prev;
+
+                if(block->prev)
+                {
+                    block->prev->next = block->next;
+                    return;
+                }
+            }
+
+            m_blocks = block->next;
+        }
+
+        static bool above(const Block* block, const Block* limit) noexcept
+        {
+            return reinterpret_cast<std::uintptr_t>(block) > reinterpret_cast<std::uintptr_t>(limit);
+        }
+
+        //compact: the last (by address) of the lowest blocks which can hold all objects
+        //(nullptr if the pool is empty), O(blocks^2)
+        Block* compact_limit() const noexcept
+        {
+            Block*      limit = nullptr;
+            std::size_t cap   = 0;
+
+            while(cap < impl().size())
+            {
+                Block* next = nullptr;
+
+                for(auto block = m_blocks; block; block = block->next)
+                {
+                    if(above(block, limit) && (!next || above(next, block)))
+                        next = block;
+                }
+
+                cap  += next->size;
+                limit = next;
+            }
+
+            return limit;
+        }
+
+        //The empty block (not current) leaves the bucket 0 and is released
+        void release_empty_block(Block* block) noexcept
+        {
+            bucket_remove(block);
+            unlink_block(block);
+
+            m_state.empty_blocks--;
+            impl().m_capacity -= block->size;
+            free_block(block);
+        }
+
+        //trim_threshold: the empty blocks are released down to the threshold, O(1) per block
+        //(the current block stays even if it's empty)
+        void trim_empty_blocks() noexcept
+        {
+            while(m_state.empty_blocks > m_state.trim_threshold && m_state.buckets[0])
+                release_empty_block(m_state.buckets[0]);
+        }
+
+        //Releases the empty blocks while capacity stays >= new_cap (TRACK),
+        //after the trim the fullest block becomes current.
+        void trim_blocks(std::size_t new_cap) noexcept
+        {
+            park_cur_block();
+
+            for(auto block = m_state.buckets[0]; block && impl().capacity() > new_cap; )
+            {
+                auto next = block->bucket_next;
+
+                if(impl().capacity() - block->size >= new_cap)
+                    release_empty_block(block);
+
+                block = next;
+            }
+
+            next_cur_block();
+        }
+
+        //The memory of blocks is from the source or from mmap (flag POOL_MMAP_BLOCKS),
+        //if mmap isn't supported (not POSIX) the flag is ignored.
+        Block* alloc_block(std::size_t size) noexcept
+        {
+            void* p = nullptr;
+
+        #if defined(POOL_MMAP)
+            if constexpr(Flags & POOL_MMAP_BLOCKS)
+            {
+                p = mmap_alloc(block_bytes(size), BLOCK_ALIGN);
+            }
+            else
+        #endif
+            p = source().allocate(block_bytes(size), BLOCK_ALIGN);
+
+            if(!p)
+                return nullptr;
+
+            auto block  = ::new (p) Block;
+            block->size = size;
+            block->live = size; //the nodes aren't in the free list yet
+
+            if constexpr(TRACK)
+            {
+                block->free_nodes = nullptr;
+                block->bucket     = NO_BUCKET;
+            }
+
+            auto nodes = reinterpret_cast<Node*>(static_cast<std::byte*>(p) + NODES_OFFSET);
+            for(std::size_t i = 0; i < size; i++)
+                ::new (nodes + i) Node;
+
+            if constexpr(SPLIT)
+            {
+                auto links = reinterpret_cast<Link*>(static_cast<std::byte*>(p) + links_offset(size));
+                for(std::size_t i = 0; i < size; i++)
+                    ::new (links + i) Link;
+            }
+
+            return block;
+        }
+
+        void free_block(Block* block) noexcept
+        {
+            const auto bytes = block_bytes(block->size);
+            impl().stat_shrink();
+            POOL_PROBE(shrink, &impl(), block, impl().capacity());
+
+            if constexpr(HANDLES)
+                release_id(block);
+
+            if constexpr(SORTED)
+                erase_sorted(block);
+
+            std::destroy_n(block->nodes(), block->size);
+
+            if constexpr(SPLIT)
+                std::destroy_n(block->links(), block->size);
+
+            std::destroy_at(block);
+
+        #if defined(POOL_MMAP)
+            if constexpr(Flags & POOL_MMAP_BLOCKS)
+            {
+                mmap_free(block, bytes);
+                return;
+            }
+        #endif
+
+            source().deallocate(block, bytes, BLOCK_ALIGN);
+        }
+
+        void readd_blocks() noexcept
+        {
+            impl().reset_free_nodes();
+            auto block = m_blocks;
+
+            while(block)
+            {
+                add_free_block(block);
+                block = block->next;
+            }
+        }
+
+        void dtor() noexcept
+        {
+            while(m_blocks)
+                del_node();
+
+            if constexpr(HANDLES)
+            {
+                if(m_state.slots)
+                    source().deallocate(m_state.slots, m_state.count * sizeof(Block_slot), alignof(Block_slot));
+
+                m_state.slots = nullptr;
+                m_state.count = 0;
+            }
+
+            if constexpr(SORTED)
+            {
+                if(m_state.sorted)
+                    source().deallocate(m_state.sorted, m_state.sorted_cap * sizeof(Block*), alignof(Block*));
+
+                m_state.sorted       = nullptr;
+                m_state.sorted_count = 0;
+                m_state.sorted_cap   = 0;
+            }
+        }
+
+
+        //SORTED: the table has the place for one more block (it grows twice)
+        bool reserve_sorted() noexcept
+        {
+            if(m_state.sorted_count < m_state.sorted_cap)
+                return true;
+
+            const auto cap    = std::max<std::size_t>(m_state.sorted_cap * 2, 8);
+            auto       sorted = static_cast<Block**>(source().allocate(cap * sizeof(Block*), alignof(Block*)));
+
+            if(!sorted)
+                return false;
+
+            std::uninitialized_copy_n(m_state.sorted, m_state.sorted_count, sorted);
+
+            if(m_state.sorted)
+                source().deallocate(m_state.sorted, m_state.sorted_cap * sizeof(Block*), alignof(Block*));
+
+            m_state.sorted     = sorted;
+            m_state.sorted_cap = cap;
+
+            return true;
+        }
+
+        static bool below(const Block* a, const Block* b) noexcept { return above(b, a); }
+
+        void insert_sorted(Block* block) noexcept
+        {
+            auto first = m_state.sorted;
+            auto last  = first + m_state.sorted_count++;
+            auto pos   = std::upper_bound(first, last, block, below);
+
+            std::copy_backward(pos, last, last + 1);
+            *pos = block;
+        }
+
+        void erase_sorted(Block* block) noexcept
+        {
+            auto first = m_state.sorted;
+            auto last  = first + m_state.sorted_count--;
+            auto pos   = std::lower_bound(first, last, block, below);
+
+            std::copy(pos + 1, last, pos);
+        }
+
+
+        //Returns the free id of block (the table grows twice), or MAX_IDS if there is none
+        std::size_t acquire_id() noexcept
+        {
+            for(std::size_t id = 0; id < m_state.count; id++)
+            {
+                if(!m_state.slots[id].block)
+                    return id;
+            }
+
+            const auto count = std::min(std::max<std::size_t>(m_state.count * 2, 8), MAX_IDS);
+
+            if(count == m_state.count)
+                return MAX_IDS;
+
+            auto slots = static_cast<Block_slot*>(source().allocate(count * sizeof(Block_slot), alignof(Block_slot)));
+
+            if(!slots)
+                return MAX_IDS;
+
+            std::uninitialized_copy_n(m_state.slots, m_state.count, slots);
+            std::uninitialized_fill_n(slots + m_state.count, count - m_state.count, Block_slot{nullptr, 0});
+
+            if(m_state.slots)
+                source().deallocate(m_state.slots, m_state.count * sizeof(Block_slot), alignof(Block_slot));
+
+            const auto id = m_state.count;
+            m_state.slots = slots;
+            m_state.count = count;
+
+            return id;
+        }
+
+        //The new block with this id starts after the generations of the released one,
+        //so the handles of its nodes stay stale
+        void release_id(Block* block) noexcept
+        {
+            auto    &slot = m_state.slots[block->id];
+            auto     gens = block->gens();
+            gen_type last = 0;
+
+            for(std::size_t i = 0; i < block->size; i++)
+                last = std::max(last, gen_type(gens[i] - slot.seed));
+
+            slot.seed  = gen_type((slot.seed + last + 2) & ~gen_type(1));
+            slot.block = nullptr;
+        }
+
+
+        //The slots of handles (see Pool_handles)
+        std::size_t slot_of(const void* obj) noexcept
+        {
+            auto block = block_of(static_cast<const Node*>(obj));
+            auto bytes = static_cast<const std::byte*>(obj) - reinterpret_cast<const std::byte*>(block->nodes());
+
+            return block->id << OFFSET_BITS | bytes / sizeof(Node);
+        }
+
+        Block* slot_block(std::size_t slot) noexcept
+        {
+            const auto id = slot >> OFFSET_BITS;
+
+            if(id >= m_state.count)
+                return nullptr;
+
+            auto block = m_state.slots[id].block;
+
+            return block && (slot & OFFSET_MASK) < block->size ? block : nullptr;
+        }
+
+        gen_type* slot_gen(std::size_t slot) noexcept
+        {
+            auto block = slot_block(slot);
+            return block ? &block->gens()[slot & OFFSET_MASK] : nullptr;
+        }
+
+        auto slot_obj(std::size_t slot) noexcept
+        {
+            return impl().get_obj(&slot_block(slot)->nodes()[slot & OFFSET_MASK]);
+        }
+
+        void move_from(Impl&& other) noexcept
+        {
+            m_blocks       = other.m_blocks;
+            m_state        = other.m_state;
+            other.m_blocks = nullptr;
+            other.m_state  = State{};
+
+            std::swap(source(), other.source()); //the blocks belong to the source
+        }
+
+    private:
+        constexpr       Impl& impl()       { return *static_cast<      Impl*>(this); }
+        constexpr const Impl& impl() const { return *static_cast<const Impl*>(this); }
+
+        template <typename, Pool_flags_t, class, class> friend class Pool_handles;
+};
+
+
+
+
+
+/*
+ * This is a minimal implementation of a bitset of N bits
+ * stored as an array of 64-bit words.
+ * Unlike std::bitset it can search the next/prev set bit: the empty words
+ * are skipped entirely (by 4 words at a time for AVX2) and inside the word
+ * the bit is found via count trailing/leading zeros.
+ */
+template <std::size_t N>
+struct word_bitset
+{
+    public:
+        using word_t = std::uint64_t;
+
+        static constexpr std::size_t BITS  = 64;
+        static constexpr std::size_t WORDS = (N + BITS - 1) / BITS;
+
+        std::array<word_t, WORDS> words{}; //the bits over N are always zero
+
+        constexpr bool test(std::size_t i) const noexcept { return words[i / BITS] & mask(i); }
+
+        constexpr void set  (std::size_t i) noexcept { words[i / BITS] |=  mask(i); }
+        constexpr void reset(std::size_t i) noexcept { words[i / BITS] &= ~mask(i); }
+        constexpr void reset()              noexcept { words.fill(0);               }
+
+
+        //Returns the position of the first set bit >= pos, or N if there is none
+        std::size_t find_next(std::size_t pos) const noexcept
+        {
+            if(pos >= N)
+                return N;
+
+            auto w    = pos / BITS;
+            auto word = words[w] & (~word_t(0) << (pos % BITS));
+
+            if(!word)
+            {
+                w = skip_zero_words(w + 1);
+
+                if(w == WORDS)
+                    return N;
+
+                word = words[w];
+            }
+
+            return w * BITS + ctz64(word);
+        }
+
+
+        //Returns the position of the last set bit <= pos, or N if there is none
+        std::size_t find_prev(std::size_t pos) const noexcept
+        {
+            if(pos >= N)
+                pos = N - 1;
+
+            auto w    = pos / BITS;
+            auto word = words[w] & (~word_t(0) >> (BITS - 1 - pos % BITS));
+
+            while(!word)
+            {
+                if(w == 0)
+                    return N;
+
+                word = words[--w];
+            }
+
+            return w * BITS + (BITS - 1 - clz64(word));
+        }
+
+
+        //Returns the position of the first zero bit, or N if there is none
+        std::size_t find_first_zero() const noexcept
+        {
+            for(std::size_t w = 0; w < WORDS; w++)
+            {
+                if(~words[w])
+                {
+                    auto pos = w * BITS + ctz64(~words[w]);
+                    return pos < N ? pos : N; //the bits over N are zero
+                }
+            }
+
+            return N;
+        }
+
+
+        //Returns true if all bits of the word w (which are less than N) are set
+        constexpr bool word_full(std::size_t w) const noexcept
+        {
+            return words[w] == word_mask(w);
+        }
+
+
+    private:
+        static constexpr word_t word_mask(std::size_t w) noexcept
+        {
+            return (w + 1 < WORDS || N % BITS == 0) ? ~word_t(0)
+                                                    : (word_t(1) << (N % BITS)) - 1;
+        }
+
+        static constexpr word_t mask(std::size_t i) noexcept { return word_t(1) << (i % BITS); }
+
+        //Returns the index of the first non-zero word >= w, or WORDS
+        std::size_t skip_zero_words(std::size_t w) const noexcept
+        {
+        #if defined(__AVX2__)
+            for(; w + 4 <= WORDS; w += 4)
+            {
+                auto v = _mm256_loadu_si256((const __m256i *)&words[w]);
+
+                if(!_mm256_testz_si256(v, v))
+                    break;
+            }
+        #endif
+
+            while(w < WORDS && !words[w])
+                w++;
+
+            return w;
+        }
+};
+
+
+
+
+
+/*
+ * Bidirectional iterator of the static pools which mark
+ * the used nodes in the word_bitset<N> m_used (the Pool must have
+ * the members: m_pool - array of nodes, m_used - bitset of the used nodes).
+ */
+template <class Pool, class Value, std::size_t N>
+class Iterator_bitset: public Iterator_facade<Iterator_bitset<Pool, Value, N>, Value>
+{
+    public:
+        Iterator_bitset() noexcept: m_cur_pos(0), m_pool(nullptr) {}
+
+        Iterator_bitset(const Pool *pool, std::size_t cur_pos) noexcept:
+            m_cur_pos(cur_pos),
+            m_pool(const_cast<Pool *>(pool))
+        {
+            if(cur_pos != N)
+                set_first_pos();
+        }
+
+        //iterator to/from const_iterator
+        template <class OtherValue>
+        Iterator_bitset(const Iterator_bitset<Pool, OtherValue, N> &other) noexcept:
+            m_cur_pos(other.m_cur_pos),
+            m_pool(other.m_pool)
+        {}
+
+    private:
+        std::size_t  m_cur_pos;
+        Pool        *m_pool;
+
+        template <class OtherValue>
+        bool equal(const Iterator_bitset<Pool, OtherValue, N> &other) const noexcept
+        {
+            return m_cur_pos == other.m_cur_pos;
+        }
+
+        void increment() noexcept { next(); }
+        void decrement() noexcept { prev(); }
+        Value& dereference() const noexcept { return (Value &)m_pool->m_pool[m_cur_pos]; }
+
+        void next() noexcept
+        {
+            if(m_cur_pos < N)
+                m_cur_pos = m_pool->m_used.find_next(m_cur_pos + 1);
+        }
+
+        void prev() noexcept
+        {
+            m_cur_pos = m_cur_pos ? m_pool->m_used.find_prev(m_cur_pos - 1) : N;
+        }
+
+        //the first used node from cur_pos (begin() is from 0)
+        void set_first_pos() noexcept
+        {
+            m_cur_pos = m_pool->m_used.find_next(m_cur_pos);
+        }
+
+        template <class, class, std::size_t> friend class Iterator_bitset;
+        friend class Iterator_facade<Iterator_bitset, Value>;
+};
+
+
+
+
+
+/*
+ * This is a minimal implementation of a circular doubly linked list.
+ * Has limited methods and is not intended to be used as a complete class.
+ */
+struct dlist_head
+{
+    public:
+        dlist_head *next;
+        dlist_head *prev;
+
+        //There is no constructor. We're gonna call init method when it's really necessary!
+        constexpr void init()        noexcept { prev = next = this;  }
+        constexpr bool empty() const noexcept { return next == this; }
+
+        void push_back(dlist_head *node) noexcept { insert(node, prev, this); }
+
+
+        /*
+         * move_to_back - deletes from current list and add to new_head
+         *
+         * new_head: the head that will follow our node
+         */
+        void move_to_back(dlist_head *new_head) noexcept
+        {
+            del_node(this);
+            new_head->push_back(this);
+        }
+
+
+        /*
+         * remove self from list.
+         * Note: empty() on node does not return true after this,
+         *       the node is in an undefined state.
+         */
+        void remove() noexcept { del_node(this); }
+
+
+        /*
+         * splice_front - transfers all the elements of src
+         * into the this head (copy to front)
+         */
+        void splice_front(dlist_head *src) noexcept
+        {
+            if(!src->empty())
+            {
+                splice(src, this, next);
+                src->init();
+            }
+        }
+
+
+    private:
+        /*
+         * Insert a new node between two known consecutive nodes.
+         *
+         * This is only for internal list manipulation when
+         * we've already known both the prev/next nodes!
+         *
+         * before:  [prev] <-> [next]
+         * after:   [prev] <-> [node] <-> [next]
+         */
+        static void insert(dlist_head *node,
+                           dlist_head *prev,
+                           dlist_head *next) noexcept
+        {
+            next->prev = node;
+            node->next = next;
+            node->prev = prev;
+            prev->next = node;
+        }
+
+
+        /*
+         * Delete a list node by making the prev/next nodes
+         * are pointing to each other
+         *
+         * This is only for internal list manipulation when
+         * we've already known both the prev/next nodes!
+         */
+        static void del(dlist_head *prev, dlist_head *next) noexcept
+        {
+            next->prev = prev;
+            prev->next = next;
+        }
+
+
+        /*
+         * Delete node from list.
+         *
+         * node: the element to delete from the list.
+         *
+         * Note: empty() on node does not return true after this,
+         *       the node is in an undefined state.
+         *
+         * before:  [prev] <-> [node] <-> [next]
+         * after:   [prev] <-> [next];              old_val <- [node] -> old_val
+         */
+        static void del_node(dlist_head *node) noexcept
+        {
+            del(node->prev, node->next);
+        }
+
+
+        static void splice(dlist_head *list,
+                           dlist_head *prev,
+                           dlist_head *next) noexcept
+        {
+            dlist_head *first = list->next;
+            dlist_head *last  = list->prev;
+
+            first->prev = prev;
+            prev->next  = first;
+
+            last->next = next;
+            next->prev = last;
+        }
+};
+
+
+
+//The link of node of Pool_dlist_base: the next free node or the links of used list.
+//POOL_SPLIT_NODES: the links are out of the nodes (see link_of)
+template <class Node>
+union Pool_dlist_link
+{
+    Node       *next;
+    dlist_head  head;
+};
+
+
+
+
+
+/*
+ * A mixin class that implements a node management algorithm
+ * based on a circular doubly-linked list
+ *
+ *  Technical details:
+ *
+ *  Each Node is a struct of a dlist_head and a type T.
+ *  Creation and Destroying is very fast - as it is a simple replacement
+ *  of pointers in a circular doubly-linked list.
+ *
+ *  POOL_SPLIT_NODES: the Node is only the object, the links are in the separate
+ *  array of Impl, it maps the node to its link and back (split_link, split_node).
+ */
+template <typename     T,
+          std::size_t  N,
+          std::size_t  Align,
+          Pool_flags_t Flags,
+          class        Impl>
+class Pool_dlist_base
+{
+    public:
+        using counter_type = std::size_t;
+
+        Pool_dlist_base() noexcept
+        {
+            m_used_nodes.init();
+        }
+
+
+        template <typename UnaryFunction>
+        void for_each(UnaryFunction f)
+        {
+            auto iter = m_used_nodes.next;
+
+            while(iter != &m_used_nodes)
+            {
+                auto next_iter = iter->next; //guard if user will delete obj(for current iter) from pool
+                f(obj_of(iter));
+                iter = next_iter;
+            }
+        }
+
+
+        void destroy(const T* obj) noexcept
+        {
+            if(!obj)
+                return;
+
+            destroy_obj(obj);
+            POOL_PROBE(destroy, &impl(), obj, impl().size());
+        }
+
+
+        //Destroys n objects (nullptr are skipped), m_size is updated once
+        void destroy_n(T* const* objs, std::size_t n) noexcept
+        {
+            std::size_t cnt = 0;
+
+            for(std::size_t i = 0; i < n; i++)
+            {
+                if(!objs[i])
+                    continue;
+
+                std::destroy_at(objs[i]);
+
+                auto node = get_node(objs[i]);
+                link_of(node)->head.remove(); //remove node from m_used_nodes
+                add_to_free_nodes(node);
+                cnt++;
+            }
+
+            impl().m_size -= cnt;
+            POOL_PROBE(destroy_n, &impl(), cnt, impl().size());
+        }
+
+
+        void destroy_all() noexcept
+        {
+            for_each([this](T* obj){ this->impl().destroy_obj(obj); });
+        }
+
+
+    private:
+        static constexpr bool SPLIT = Flags & POOL_SPLIT_NODES;
+
+        //POOL_SPLIT_NODES: the iterator finds the object of link by the pool
+        struct Iterator_pool {
+            explicit Iterator_pool(const Pool_dlist_base *pool) noexcept:
+                m_pool(const_cast<Pool_dlist_base *>(pool)) {}
+
+            Pool_dlist_base *m_pool;
+        };
+
+        struct Iterator_no_pool {
+            explicit Iterator_no_pool(const Pool_dlist_base *) noexcept {}
+        };
+
+        using Iterator_pool_t = std::conditional_t<SPLIT, Iterator_pool, Iterator_no_pool>;
+
+
+    public:
+        template <class Value>
+        class Iterator_t: public Iterator_facade<Iterator_t<Value>, Value>,
+                          private Iterator_pool_t
+        {
+            public:
+                explicit Iterator_t(const dlist_head *node = nullptr, const Pool_dlist_base *pool = nullptr) noexcept:
+                    Iterator_pool_t(pool), m_node(const_cast<dlist_head *>(node)) {}
+
+                template <class OtherValue>
+                Iterator_t(const Iterator_t<OtherValue> &other) noexcept:
+                    Iterator_pool_t(other), m_node(other.m_node) {}
+
+            private:
+                dlist_head *m_node;
+
+                template <class OtherValue>
+                bool equal(const Iterator_t<OtherValue> &other) const noexcept
+                {
+                    return m_node == other.m_node;
+                }
+
+                void increment() noexcept { m_node = m_node->next; }
+                void decrement() noexcept { m_node = m_node->prev; }
+                Value& dereference() const noexcept
+                {
+                    if constexpr(SPLIT)
+                        return *(Value *)this->m_pool->obj_of(m_node);
+                    else
+                        return *(Value *)Pool_dlist_base::get_data(m_node);
+                }
+
+                template <class> friend class Iterator_t;
+                friend class Iterator_facade<Iterator_t, Value>;
+                friend class Pool_dlist_base;
+        };
+
+        using iterator               = Iterator_t<T>;
+        using const_iterator         = Iterator_t<const T>;
+        using reverse_iterator       = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        constexpr auto begin() noexcept       { return iterator(m_used_nodes.next, this); }
+        constexpr auto end()   noexcept       { return iterator(&m_used_nodes,     this); }
+
+        constexpr auto begin() const noexcept { return const_iterator(m_used_nodes.next, this); }
+        constexpr auto end()   const noexcept { return const_iterator(&m_used_nodes,     this); }
+        constexpr auto cbegin()const noexcept { return const_iterator(m_used_nodes.next, this); }
+        constexpr auto cend()  const noexcept { return const_iterator(&m_used_nodes,     this); }
+
+        constexpr auto rbegin() noexcept       { return reverse_iterator(end());   }
+        constexpr auto rend()   noexcept       { return reverse_iterator(begin()); }
+
+        constexpr auto rbegin() const noexcept { return const_reverse_iterator(end());   }
+        constexpr auto rend()   const noexcept { return const_reverse_iterator(begin()); }
+        constexpr auto crbegin()const noexcept { return const_reverse_iterator(cend());  }
+        constexpr auto crend()  const noexcept { return const_reverse_iterator(cbegin());}
+
+        iterator destroy(const_iterator pos) noexcept
+        {
+            iterator ret(pos.m_node->next, this);
+            destroy_obj(&(*pos));
+
+            return ret;
+        }
+
+
+        iterator destroy(const_iterator first, const_iterator last) noexcept
+        {
+            while (first != last)
+              first = destroy(first);
+
+            return last;
+        }
+
+
+    protected:
+        using Data = struct { alignas(pool_data_align(Align, Flags)) std::byte data[sizeof(T)]; };
+
+        struct Link_node {
+            union {
+            Link_node  *next;
+            dlist_head  head;
+            };
+            Data        data;
+        };
+
+        using Node = std::conditional_t<SPLIT, Data, Link_node>;
+        using Link = std::conditional_t<SPLIT, Pool_dlist_link<Node>, Link_node>; //the node is own link
+
+        Node       *m_free_nodes{nullptr};
+        dlist_head  m_used_nodes;
+
+
+        template <typename... Args>
+        T* create_obj(Args&&... args) noexcept(is_nothrow_create<T, Args...>)
+        {
+            if(!m_free_nodes)
+                return nullptr;
+
+            auto free_node = m_free_nodes;
+            auto obj       = ::new ((void *)get_obj(free_node)) T(std::forward<Args>(args)...);
+
+            //---- Kalb line ----
+            auto link    = link_of(free_node);
+            m_free_nodes = link->next;
+            m_used_nodes.push_back(&link->head);
+            impl().m_size++;
+            impl().node_taken(free_node);
+
+            return obj;
+        }
+
+        void destroy_obj(const T* obj) noexcept
+        {
+            impl().m_size--;
+            std::destroy_at(obj);
+
+            auto node = get_node(obj);
+            link_of(node)->head.remove(); //remove node from m_used_nodes
+            add_to_free_nodes(node);
+        }
+
+        //Returns all nodes to the free list (the objects are destroyed)
+        void release_all() noexcept
+        {
+            for_each([this](T* obj){ this->release_node(obj); });
+            m_used_nodes.init();
+        }
+
+        //Moves the object to the node from the free list, the new node takes the place
+        //of old one in the used list. The old node isn't returned to the free list.
+        template <typename RelocateFunction>
+        T* relocate_obj(T* obj, RelocateFunction& relocate) noexcept
+        {
+            auto free_node = m_free_nodes;
+            auto free_link = link_of(free_node);
+            auto new_obj   = ::new ((void *)get_obj(free_node)) T(std::move(*obj));
+
+            m_free_nodes = free_link->next;
+            impl().node_taken(free_node);
+
+            relocate(obj, new_obj);
+            std::destroy_at(obj);
+
+            auto link = link_of(get_node(obj));
+            link->head.push_back(&free_link->head); //before the old node
+            link->head.remove();
+
+            return new_obj;
+        }
+
+        //Takes up to n nodes from the free list in one walk
+        template <typename... Args>
+        std::size_t create_n_obj(T** objs, std::size_t n, const Args&... args)
+        {
+            std::size_t cnt = 0;
+
+            for(; cnt < n && m_free_nodes; cnt++)
+            {
+                auto node    = m_free_nodes;
+                m_free_nodes = link_of(node)->next;
+                objs[cnt]    = get_obj(node);
+                impl().node_taken(node);
+            }
+
+            construct_n(objs, cnt, args...);
+
+            return cnt;
+        }
+
+        //Creates objects in all nodes (nodes are not in the free list)
+        template <typename... Args>
+        void create_n_nodes(Node* nodes, std::size_t n, T** objs, const Args&... args)
+        {
+            for(std::size_t i = 0; i < n; i++)
+                objs[i] = get_obj(&nodes[i]);
+
+            construct_n(objs, n, args...);
+        }
+
+        template <typename... Args>
+        void construct_n(T** objs, std::size_t n, const Args&... args)
+        {
+            impl().m_size += n;
+            create_n_saver<T, Pool_dlist_base> saver{*this, objs, n};
+
+            for(; saver.cnt < n; saver.cnt++)
+            {
+                auto obj = ::new ((void *)objs[saver.cnt]) T(args...);
+                m_used_nodes.push_back(&link_of(get_node(obj))->head);
+            }
+        }
+
+        //Returns the node (without object) to the free list
+        void release_node(const T* obj) noexcept
+        {
+            impl().m_size--;
+            add_to_free_nodes(get_node(obj));
+        }
+
+        static constexpr Node* get_node(const T* obj) noexcept
+        {
+            if constexpr(SPLIT)
+                return (Node *)obj;
+            else
+                return (Node *)((char *)obj - offsetof(Link_node, data));
+        }
+
+        static constexpr T* get_obj(Node* node) noexcept
+        {
+            if constexpr(SPLIT)
+                return (T *)node;
+            else
+                return (T *)&node->data;
+        }
+
+        static constexpr void* get_data(const dlist_head* head) noexcept {
+            return ((char *)head + offsetof(Link_node, data));
+        }
+
+        constexpr Link* link_of(Node* node) noexcept
+        {
+            if constexpr(SPLIT)
+                return impl().split_link(node);
+            else
+                return node;
+        }
+
+        //The object of node in the used list
+        T* obj_of(dlist_head* head) noexcept
+        {
+            if constexpr(SPLIT)
+                return get_obj(impl().split_node(reinterpret_cast<Link*>(head)));
+            else
+                return (T *)get_data(head);
+        }
+
+        constexpr Node* top_free_node()    noexcept { return m_free_nodes;   }
+        constexpr void  reset_free_nodes() noexcept { m_free_nodes = nullptr;}
+
+        //If m_free_nodes == nullptr calling pop_free_node is undefined
+        constexpr void pop_free_node() noexcept
+        {
+            auto free_node = m_free_nodes;
+            m_free_nodes   = link_of(free_node)->next;
+            impl().node_taken(free_node);
+        }
+
+        constexpr void add_to_free_nodes(Node* node) noexcept
+        {
+            link_of(node)->next = m_free_nodes;
+            m_free_nodes        = node;
+            impl().node_freed(node);
+        }
+
+        //The new nodes (without the hook node_freed)
+        constexpr void add_to_free_nodes(Node* nodes, std::size_t n) noexcept
+        {
+            for(std::size_t i = 0; i < n; i++)
+            {
+                link_of(&nodes[i])->next = m_free_nodes;
+                m_free_nodes             = &nodes[i];
+            }
+        }
+
+
+        void move_from(Impl&& other) noexcept //only for dynamic
+        {
+            impl().m_size       = other.m_size;
+            impl().m_capacity   = other.m_capacity;
+            impl().m_free_nodes = other.m_free_nodes;
+            impl().m_used_nodes.splice_front(&other.m_used_nodes);
+
+            other.m_size       = 0;
+            other.m_capacity   = 0;
+            other.m_free_nodes = nullptr;
+        }
+
+
+    private:
+        constexpr Impl& impl() { return *static_cast<Impl*>(this); }
+
+        template <class, class, class>                                               friend class Pool_node_allocator;
+        template <std::size_t, Pool_flags_t, class, class, class>                    friend class Pool_block_allocator;
+        template <typename, std::size_t, std::size_t, Pool_flags_t, class, typename> friend class Pool_base;
+        friend create_n_saver<T, Pool_dlist_base>;
+        friend create_n_rollback<T, Pool_dlist_base>;
+};
+
+
+
+
+
+/*
+ * A mixin class that implements a node management algorithm
+ * based on a singly-linked list
+ *
+ *  Technical details:
+ *
+ *  Each Node is a union of a pointer and a type T.
+ *  Free nodes contain a pointer to the next free node.
+ *  Creation is quick as all that is necessary
+ *  is to return the address of the next free node.
+ *  Destroying also very quick as the node's content is simply
+ *  replaced with the address of the current next free node.
+ */
+template <typename     T,
+          std::size_t  N,
+          std::size_t  Align,
+          Pool_flags_t Flags,
+          class        Impl>
+class Pool_list_base
+{
+    public:
+        using counter_type = std::size_t;
+
+        void destroy(const T* obj) noexcept
+        {
+            if(!obj)
+                return;
+
+            destroy_obj(obj);
+            POOL_PROBE(destroy, &impl(), obj, impl().size());
+        }
+
+
+        //Destroys n objects (nullptr are skipped), m_size is updated once
+        void destroy_n(T* const* objs, std::size_t n) noexcept
+        {
+            std::size_t cnt = 0;
+
+            for(std::size_t i = 0; i < n; i++)
+            {
+                if(!objs[i])
+                    continue;
+
+                std::destroy_at(objs[i]);
+                add_to_free_nodes((Node*)objs[i]);
+                cnt++;
+            }
+
+            impl().m_size -= cnt;
+            POOL_PROBE(destroy_n, &impl(), cnt, impl().size());
+        }
+
+
+    protected:
+        using Data = struct { alignas(pool_data_align(Align, Flags)) std::byte data[sizeof(T)]; };
+
+        union Node {
+            Node* next;
+            Data  data;
+        };
+
+        Node* m_free_nodes{nullptr};
+
+
+        template<class S>
+        class state_saver
+        {
+            private:
+                S  stored_value;
+                S& obj_ref;
+
+            public:
+                state_saver(S& object) noexcept:
+                    stored_value(object),
+                    obj_ref(object)
+                {}
+
+                ~state_saver() noexcept { if (enable) obj_ref = stored_value; }
+
+                bool enable{true};
+        };
+
+
+        template <typename... Args>
+        T* create_obj(Args&&... args) noexcept(is_nothrow_create<T, Args...>)
+        {
+            if(!m_free_nodes)
+                return nullptr;
+
+            auto next_node = m_free_nodes->next;
+
+            //Saver is a RAII for restore of state(linked list)
+            //in case ctor of object will thrown an exception.
+            //It is needed for basic exception guarantee.
+            //INFO: Some MSVC and mingw32 gcc version 7.3.0
+            //get internal compiler error:(for Auto Type Deduction for state_saver)
+            //The solution is to set the type manually
+            state_saver<Node*> saver(m_free_nodes->next);
+            auto obj     = ::new (m_free_nodes) T(std::forward<Args>(args)...);
+            saver.enable = false; //ctor of object did not throw an exception, all ok
+
+            //---- Kalb line ----
+            impl().m_size++;
+            m_free_nodes = next_node;
+            impl().node_taken((Node*)obj);
+
+            return obj;
+        }
+
+        void destroy_obj(const T* obj) noexcept
+        {
+            impl().m_size--;
+            std::destroy_at(obj);
+
+            add_to_free_nodes((Node*)obj);
+        }
+
+        //Takes up to n nodes from the free list in one walk
+        template <typename... Args>
+        std::size_t create_n_obj(T** objs, std::size_t n, const Args&... args)
+        {
+            std::size_t cnt = 0;
+
+            for(; cnt < n && m_free_nodes; cnt++)
+            {
+                auto node    = m_free_nodes;
+                m_free_nodes = node->next;
+                objs[cnt]    = (T *)node;
+                impl().node_taken(node);
+            }
+
+            construct_n(objs, cnt, args...);
+
+            return cnt;
+        }
+
+        //Creates objects in all nodes (nodes are not in the free list)
+        template <typename... Args>
+        void create_n_nodes(Node* nodes, std::size_t n, T** objs, const Args&... args)
+        {
+            for(std::size_t i = 0; i < n; i++)
+                objs[i] = (T *)&nodes[i];
+
+            construct_n(objs, n, args...);
+        }
+
+        template <typename... Args>
+        void construct_n(T** objs, std::size_t n, const Args&... args)
+        {
+            impl().m_size += n;
+            create_n_saver<T, Pool_list_base> saver{*this, objs, n};
+
+            for(; saver.cnt < n; saver.cnt++)
+                ::new ((void *)objs[saver.cnt]) T(args...);
+        }
+
+        //Returns the node (without object) to the free list
+        void release_node(const T* obj) noexcept
+        {
+            impl().m_size--;
+            add_to_free_nodes((Node*)obj);
+        }
+
+        static constexpr T* get_obj(Node* node) noexcept { return (T *)node; }
+
+        //This algorithm does not support the for_each method and,
+        //as a consequence, the destroy_all method. But we declare it empty
+        //so that we can call it in the derived (if necessary).
+        //We can use SFINAE test to check if a method destroy_all() exists
+        //but this is more code than just declaring a non-public empty method
+        //that will be removed by the compiler.
+        void destroy_all() noexcept {}
+
+        constexpr void add_to_free_nodes(Node* node) noexcept
+        {
+            node->next   = m_free_nodes;
+            m_free_nodes = node;
+            impl().node_freed(node);
+        }
+
+        //The new nodes (without the hook node_freed)
+        constexpr void add_to_free_nodes(Node* nodes, std::size_t n) noexcept
+        {
+            for(std::size_t i = 0; i < n; i++)
+            {
+                nodes[i].next = m_free_nodes;
+                m_free_nodes  = &nodes[i];
+            }
+        }
+
+        constexpr Node* top_free_node()    noexcept { return m_free_nodes;   }
+        constexpr void  reset_free_nodes() noexcept { m_free_nodes = nullptr;}
+
+        //If m_free_nodes == nullptr calling pop_free_node is undefined
+        constexpr void pop_free_node() noexcept
+        {
+            auto free_node = m_free_nodes;
+            m_free_nodes   = free_node->next;
+            impl().node_taken(free_node);
+        }
+
+
+        void move_from(Impl&& other) noexcept //only for dynamic
+        {
+            impl().m_size       = other.m_size;
+            impl().m_capacity   = other.m_capacity;
+            impl().m_free_nodes = other.m_free_nodes;
+
+            other.m_size        = 0;
+            other.m_capacity    = 0;
+            other.m_free_nodes  = nullptr;
+        }
+
+
+    private:
+        constexpr Impl& impl() { return *static_cast<Impl*>(this); }
+
+        template <class, class, class>              friend class Pool_node_allocator;
+        template <std::size_t, Pool_flags_t, class, class, class> friend class Pool_block_allocator;
+        friend create_n_saver<T, Pool_list_base>;
+        friend create_n_rollback<T, Pool_list_base>;
+};
+
+
+
+
+
+/*
+ * A mixin class that implements a node management algorithm
+ * based on a lock-free singly-linked list (Treiber stack)
+ *
+ *  Technical details:
+ *
+ *  It's analogue of Pool_list_base, but methods create/destroy can be
+ *  called concurrently from different threads.
+ *  The head of the free list is a pair {pointer, tag}. The tag is changed
+ *  on each update of the head, it's a protection from the ABA problem.
+ *  The head is updated via double-width CAS (cmpxchg16b on x86-64),
+ *  for GCC it may require libatomic (-latomic).
+ *
+ *  The counters m_size and m_capacity are atomic.
+ *  Adding of new nodes (growth of pool) is a rare event, so it is
+ *  serialized via mutex. The methods reserve, shrink_to_fit, move
+ *  and destructor are not thread-safe.
+ *
+ *  Nodes are never returned to the memory manager while the pool is used
+ *  concurrently, so reading node->next of a node that was already taken
+ *  by another thread is safe (the CAS will fail because the tag is changed).
+ */
+template <typename     T,
+          std::size_t  N,
+          std::size_t  Align,
+          Pool_flags_t Flags,
+          class        Impl>
+class Pool_list_mt_base
+{
+    static_assert(!(Flags & (POOL_TRIM_BLOCKS | POOL_FULLEST_BLOCK)), "The counts of live nodes in blocks aren't thread-safe");
+    static_assert(!pool_handles(Flags), "The generations of handles aren't thread-safe");
+    static_assert(!(Flags & POOL_STATS), "The counters of statistics aren't thread-safe");
+
+    public:
+        using counter_type = std::atomic<std::size_t>;
+
+        void destroy(const T* obj) noexcept
+        {
+            if(!obj)
+                return;
+
+            destroy_obj(obj);
+            POOL_PROBE(destroy, &impl(), obj, impl().size());
+        }
+
+
+        //Destroys n objects (nullptr are skipped),
+        //the nodes are returned to the free list via one CAS
+        void destroy_n(T* const* objs, std::size_t n) noexcept
+        {
+            Node*       first = nullptr;
+            Node*       last  = nullptr;
+            std::size_t cnt   = 0;
+
+            for(std::size_t i = 0; i < n; i++)
+            {
+                if(!objs[i])
+                    continue;
+
+                std::destroy_at(objs[i]);
+
+                auto node = get_node(objs[i]);
+                node->next.store(first, std::memory_order_relaxed);
+                first     = node;
+
+                if(!last)
+                    last = node;
+
+                cnt++;
+            }
+
+            if(!cnt)
+                return;
+
+            impl().m_size.fetch_sub(cnt, std::memory_order_relaxed);
+            push_nodes(first, last);
+            POOL_PROBE(destroy_n, &impl(), cnt, impl().size());
+        }
+
+
+    protected:
+        using Data = struct { alignas(pool_data_align(Align, Flags)) std::byte data[sizeof(T)]; };
+
+        //The link doesn't overlap the object: the other thread may still
+        //read the link of a node which has been taken and is being constructed
+        struct Node {
+            std::atomic<Node*> next;
+            Data               data;
+        };
+
+        struct alignas(2 * sizeof(void*)) Tagged_ptr {
+            Node*          ptr;
+            std::uintptr_t tag;
+        };
+
+        std::atomic<Tagged_ptr> m_free_nodes{Tagged_ptr{nullptr, 0}};
+        std::mutex              m_grow_mutex;
+
+
+        //RAII for return of node to the free list
+        //in case ctor of object will thrown an exception.
+        struct node_saver
+        {
+            Pool_list_mt_base* pool;
+            Node*              node;
+
+            ~node_saver() noexcept { if(node) pool->push_nodes(node, node); }
+        };
+
+
+        template <typename... Args>
+        T* create_obj(Args&&... args) noexcept(is_nothrow_create<T, Args...>)
+        {
+            auto node = take_node();
+
+            if(!node)
+                return nullptr;
+
+            node_saver saver{this, node};
+            auto obj    = ::new ((void *)get_obj(node)) T(std::forward<Args>(args)...);
+            saver.node  = nullptr; //ctor of object did not throw an exception, all ok
+
+            //---- Kalb line ----
+            impl().m_size.fetch_add(1, std::memory_order_relaxed);
+
+            return obj;
+        }
+
+        void destroy_obj(const T* obj) noexcept
+        {
+            impl().m_size.fetch_sub(1, std::memory_order_relaxed);
+            std::destroy_at(obj);
+
+            add_to_free_nodes(get_node(obj));
+        }
+
+        //The nodes are taken one by one. Walk along the chain of the free
+        //nodes isn't safe, they may be taken by the other threads.
+        template <typename... Args>
+        std::size_t create_n_obj(T** objs, std::size_t n, const Args&... args)
+        {
+            create_n_saver<T, Pool_list_mt_base> saver{*this, objs};
+
+            while(saver.n < n)
+            {
+                auto node = take_node();
+
+                if(!node)
+                    break;
+
+                objs[saver.n++] = get_obj(node);
+                impl().m_size.fetch_add(1, std::memory_order_relaxed);
+
+                ::new ((void *)get_obj(node)) T(args...);
+                saver.cnt++;
+            }
+
+            return saver.cnt;
+        }
+
+        //Returns the node (without object) to the free list
+        void release_node(const T* obj) noexcept
+        {
+            impl().m_size.fetch_sub(1, std::memory_order_relaxed);
+            add_to_free_nodes(get_node(obj));
+        }
+
+        static Node* get_node(const T* obj) noexcept {
+            return (Node *)((char *)obj - offsetof(Node, data));
+        }
+
+        static T* get_obj(Node* node) noexcept { return (T *)&node->data; }
+
+        //This algorithm does not support the for_each method (see Pool_list_base)
+        void destroy_all() noexcept {}
+
+
+        Node* take_node() noexcept
+        {
+            auto node = pop_node();
+
+            if constexpr( !(Flags & POOL_FIXED_CAPACITY) )
+            {
+                while(!node && grow())
+                    node = pop_node();
+            }
+
+            return node;
+        }
+
+
+        //Returns false if the pool can't get a new nodes
+        bool grow() noexcept
+        {
+            std::lock_guard<std::mutex> lock(m_grow_mutex);
+
+            if(top_free_node()) //other thread has already added nodes
+                return true;
+
+            auto old_cap = impl().capacity();
+            impl().add_node();
+
+            return impl().capacity() != old_cap;
+        }
+
+        Node* pop_node() noexcept
+        {
+            auto head = m_free_nodes.load(std::memory_order_acquire);
+
+            while(head.ptr)
+            {
+                Tagged_ptr new_head{head.ptr->next.load(std::memory_order_relaxed), head.tag + 1};
+
+                if(m_free_nodes.compare_exchange_weak(head, new_head,
+                                                      std::memory_order_acq_rel,
+                                                      std::memory_order_acquire))
+                    break;
+            }
+
+            return head.ptr;
+        }
+
+        //push the chain first->...->last to the free list via one CAS
+        void push_nodes(Node* first, Node* last) noexcept
+        {
+            auto head = m_free_nodes.load(std::memory_order_relaxed);
+
+            do
+            {
+                last->next.store(head.ptr, std::memory_order_relaxed);
+            }
+            while(!m_free_nodes.compare_exchange_weak(head, Tagged_ptr{first, head.tag + 1},
+                                                      std::memory_order_release,
+                                                      std::memory_order_relaxed));
+        }
+
+        void add_to_free_nodes(Node* node) noexcept
+        {
+            push_nodes(node, node);
+        }
+
+        void add_to_free_nodes(Node* nodes, std::size_t n) noexcept
+        {
+            for(std::size_t i = 0; i + 1 < n; i++)
+                nodes[i].next.store(&nodes[i + 1], std::memory_order_relaxed);
+
+            push_nodes(&nodes[0], &nodes[n - 1]);
+        }
+
+        Node* top_free_node() noexcept
+        {
+            return m_free_nodes.load(std::memory_order_acquire).ptr;
+        }
+
+        void reset_free_nodes() noexcept
+        {
+            m_free_nodes.store(Tagged_ptr{nullptr, 0}, std::memory_order_relaxed);
+        }
+
+        //If m_free_nodes == nullptr calling pop_free_node is undefined
+        void pop_free_node() noexcept { pop_node(); }
+
+
+        void move_from(Impl&& other) noexcept //only for dynamic
+        {
+            impl().m_size.store(other.m_size.load());
+            impl().m_capacity.store(other.m_capacity.load());
+            impl().m_free_nodes.store(other.m_free_nodes.load());
+
+            other.m_size.store(0);
+            other.m_capacity.store(0);
+            other.reset_free_nodes();
+        }
+
+
+    private:
+        constexpr Impl& impl() { return *static_cast<Impl*>(this); }
+
+        template <class, class, class>              friend class Pool_node_allocator;
+        template <std::size_t, Pool_flags_t, class, class, class> friend class Pool_block_allocator;
+        friend create_n_saver<T, Pool_list_mt_base>;
+};
+
+
+
+
+
+/*
+ * The lazy free list of static pool (SPool_list, SPool_list_bitset, SPool_dlist)
+ *
+ * The nodes [m_bump, N) were never used and they aren't in the free list:
+ * the free list gets the next untouched node only when it's empty (or the
+ * nodes for create_n), so the ctor doesn't write the links of N nodes and
+ * the pages of never used nodes aren't faulted in. The free list has
+ * m_bump - size() nodes: the returned ones are used first (they are hot).
+ */
+template <std::size_t N>
+struct SPool_bump_index
+{
+    std::size_t m_bump = 0;
+
+    //Returns the count of untouched nodes [m_bump - cnt, m_bump) which
+    //must be added to the free list, so it will have n nodes (if the pool has them)
+    constexpr std::size_t bump(std::size_t n, std::size_t size) noexcept
+    {
+        const auto free = m_bump - size;
+
+        if(free >= n)
+            return 0;
+
+        const auto cnt = std::min(n - free, N - m_bump);
+        m_bump += cnt;
+
+        return cnt;
+    }
+};
+
+
+
+/*
+ *  Static object pool is implemented on a singly-linked list
+ *
+ *  Technical details:
+ *
+ *  We don't store information(list) of the used nodes.
+ *  This gives a lot of complexity == O(N^2) for the for_each algorithm.
+ */
+template <typename     T,
+          std::size_t  N,
+          std::size_t  Align = alignof(T),
+          Pool_flags_t Flags = 0>
+class SPool_list: public SPool_base<T, N, Align, Flags,
+                                    SPool_list<T, N, Align, Flags> >,
+                  public Pool_list_base<T, N, Align, Flags,
+                                        SPool_list<T, N, Align, Flags> >,
+                  private SPool_bump_index<N>
+{
+    public:
+        SPool_list() = default;
+
+
+        template <typename UnaryFunction>
+        void for_each(UnaryFunction f)
+        {
+            if(this->empty())
+                return;
+
+
+            if(this->full()) //complexity == O(N)
+            {
+                for(auto &node : m_pool)
+                    f((T *)&node);
+
+                return;
+            }
+
+            //The pool is not empty and not full, we have no information
+            //about the nodes used. But there is a list of free ones,
+            //this check leads to the complexity == O(N^2)
+            //(the nodes [m_bump, N) were never used)
+            for(std::size_t i = 0; i < this->m_bump; i++)
+            {
+                if(node_is_used(&m_pool[i]))
+                    f((T *)&m_pool[i]);
+            }
+        }
+
+
+        void destroy_all() noexcept
+        {
+            for_each([this](T* obj){ this->destroy_obj(obj); });
+        }
+
+
+    private:
+        using Base = Pool_list_base<T, N, Align, Flags, SPool_list>;
+        using Node = typename Base::Node;
+
+        std::array<Node, N> m_pool;
+
+
+        template <typename... Args>
+        T* create_obj(Args&&... args) noexcept(is_nothrow_create<T, Args...>)
+        {
+            bump_nodes(1);
+            return Base::create_obj(std::forward<Args>(args)...);
+        }
+
+        template <typename... Args>
+        std::size_t create_n_obj(T** objs, std::size_t n, const Args&... args)
+        {
+            bump_nodes(n);
+            return Base::create_n_obj(objs, n, args...);
+        }
+
+        //The free list gets the untouched nodes (see SPool_bump_index)
+        void bump_nodes(std::size_t n) noexcept
+        {
+            if(const auto cnt = this->bump(n, this->size()))
+            {
+                if constexpr(pool_handles(Flags))
+                    this->init_gens(this->m_bump - cnt, cnt);
+
+                this->add_to_free_nodes(&m_pool[this->m_bump - cnt], cnt);
+            }
+        }
+
+        bool node_is_used(const Node* node) const noexcept
+        {
+            const Node* free_node = this->m_free_nodes;
+
+            while(free_node)
+            {
+                if(node == free_node)
+                    return false;
+
+                free_node = free_node->next;
+            }
+
+            return true;
+        }
+
+        friend SPool_base    <T, N, Align, Flags, SPool_list>;
+        friend Pool_list_base<T, N, Align, Flags, SPool_list>;
+        friend Pool_base     <T, N, Align, Flags, SPool_list>;
+        friend SPool_handles <T, N, Flags, SPool_list>;
+};
+
+
+
+
+
+/*
+ *  Static object pool is implemented on a singly-linked list + bitset
+ *
+ *  Technical details:
+ *
+ *  It's analogue of SPool_list, but we use bitset for the used nodes.
+ *  This gives a complexity == O(N) for the for_each algorithm.
+ */
+template <typename     T,
+          std::size_t  N,
+          std::size_t  Align = alignof(T),
+          Pool_flags_t Flags = 0>
+class SPool_list_bitset: public SPool_base<T, N, Align, Flags,
+                                           SPool_list_bitset<T, N, Align, Flags> >,
+                         public Pool_list_base<T, N, Align, Flags,
+                                               SPool_list_bitset<T, N, Align, Flags> >,
+                         private SPool_bump_index<N>
+{
+    public:
+        SPool_list_bitset() = default;
+
+
+        void destroy(const T* obj) noexcept
+        {
+            if(!obj)
+                return;
+
+            m_used.reset(index_node((const Node*)obj));
+            this->destroy_obj(obj);
+            POOL_PROBE(destroy, this, obj, this->size());
+        }
+
+
+        void destroy_n(T* const* objs, std::size_t n) noexcept
+        {
+            for(std::size_t i = 0; i < n; i++)
+            {
+                if(objs[i])
+                    m_used.reset(index_node((const Node*)objs[i]));
+            }
+
+            Base::destroy_n(objs, n);
+        }
+
+
+        template <typename UnaryFunction>
+        void for_each(UnaryFunction f)
+        {
+            if(this->empty())
+                return;
+
+            //guard if user will delete obj(for current i) from pool: search from i + 1
+            for(auto i = m_used.find_next(0); i < N; i = m_used.find_next(i + 1))
+                f((T *)&m_pool[i]);
+        }
+
+
+        void destroy_all() noexcept
+        {
+            for_each([this](T* obj){ this->destroy_obj(obj); });
+            m_used.reset();
+        }
+
+
+        using iterator               = Iterator_bitset<SPool_list_bitset, T, N>;
+        using const_iterator         = Iterator_bitset<SPool_list_bitset, const T, N>;
+        using reverse_iterator       = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        constexpr auto begin() noexcept       { return iterator(this, 0); }
+        constexpr auto end()   noexcept       { return iterator(this, N); }
+
+        constexpr auto begin() const noexcept { return const_iterator(this, 0); }
+        constexpr auto end()   const noexcept { return const_iterator(this, N); }
+        constexpr auto cbegin()const noexcept { return const_iterator(this, 0); }
+        constexpr auto cend()  const noexcept { return const_iterator(this, N); }
+
+        constexpr auto rbegin() noexcept       { return reverse_iterator(end());   }
+        constexpr auto rend()   noexcept       { return reverse_iterator(begin()); }
+
+        constexpr auto rbegin() const noexcept { return const_reverse_iterator(end());   }
+        constexpr auto rend()   const noexcept { return const_reverse_iterator(begin()); }
+        constexpr auto crbegin()const noexcept { return const_reverse_iterator(cend());  }
+        constexpr auto crend()  const noexcept { return const_reverse_iterator(cbegin());}
+
+        iterator destroy(const_iterator pos) noexcept
+        {
+            auto ret = pos;
+            ++ret;
+            destroy(&(*pos));
+            return ret;
+        }
+
+
+        iterator destroy(const_iterator first, const_iterator last) noexcept
+        {
+            while (first != last)
+              first = destroy(first);
+
+            return last;
+        }
+
+
+    private:
+        using Base = Pool_list_base<T, N, Align, Flags, SPool_list_bitset>;
+        using Node = typename Base::Node;
+
+        std::array<Node, N> m_pool;
+        word_bitset<N>      m_used; //0 - free, 1 - is used
+
+
+        //The create methods of Pool_base (the counters, the probes) mark the used nodes
+        template <typename... Args>
+        T* create_obj(Args&&... args) noexcept(is_nothrow_create<T, Args...>)
+        {
+            bump_nodes(1);
+
+            if(!this->m_free_nodes)
+                return nullptr;
+
+            auto i   = index_node(this->m_free_nodes);
+            auto obj = Base::create_obj(std::forward<Args>(args)...);
+
+            //---- Kalb line ----
+            m_used.set(i);
+
+            return obj;
+        }
+
+        template <typename... Args>
+        std::size_t create_n_obj(T** objs, std::size_t n, const Args&... args)
+        {
+            bump_nodes(n);
+
+            auto cnt = Base::create_n_obj(objs, n, args...);
+
+            //---- Kalb line ----
+            for(std::size_t i = 0; i < cnt; i++)
+                m_used.set(index_node((const Node*)objs[i]));
+
+            return cnt;
+        }
+
+        constexpr std::size_t index_node(const Node* node) const noexcept {
+            return std::distance(m_pool.cbegin(), node);
+        }
+
+        //Returns all nodes to the free list (the objects are destroyed)
+        void release_all() noexcept
+        {
+            for_each([this](T* obj){ this->release_node(obj); });
+            m_used.reset();
+        }
+
+        //The free list gets the untouched nodes (see SPool_bump_index)
+        void bump_nodes(std::size_t n) noexcept
+        {
+            if(const auto cnt = this->bump(n, this->size()))
+            {
+                if constexpr(pool_handles(Flags))
+                    this->init_gens(this->m_bump - cnt, cnt);
+
+                this->add_to_free_nodes(&m_pool[this->m_bump - cnt], cnt);
+            }
+        }
+
+        template <class, class, std::size_t> friend class Iterator_bitset;
+        friend Pool_base     <T, N, Align, Flags, SPool_list_bitset>;
+        friend Pool_list_base<T, N, Align, Flags, SPool_list_bitset>;
+        friend SPool_base    <T, N, Align, Flags, SPool_list_bitset>;
+        friend SPool_handles <T, N, Flags, SPool_list_bitset>;
+};
+
+
+
+
+
+/*
+ *  Static object pool is implemented on a hierarchical bitmap
+ *
+ *  Technical details:
+ *
+ *  There is no free list: the nodes contain only objects and the free nodes
+ *  are never read or written, so their cache lines stay cold.
+ *  The used nodes are marked in the leaf bitset m_used (it's also the index
+ *  for for_each and iterators, as in SPool_list_bitset), the summary bitset
+ *  m_full marks the leaf words which have no free bits.
+ *  create() finds the first non-full leaf word in the summary and the first
+ *  zero bit in it via count trailing zeros (tzcnt), so for N <= 4096
+ *  it reads one summary word and one leaf word.
+ *  The summary marks the full words (not the non-full ones), so the
+ *  zero-initialized bitmap is an empty pool and nodes aren't touched in ctor.
+ */
+template <typename     T,
+          std::size_t  N,
+          std::size_t  Align = alignof(T),
+          Pool_flags_t Flags = 0>
+class SPool_bitmap: public SPool_base<T, N, Align, Flags,
+                                      SPool_bitmap<T, N, Align, Flags> >
+{
+    public:
+        SPool_bitmap() = default;
+
+        //The pool has no pointers: its bytes are its snapshot (see pool_save)
+        static constexpr std::uint32_t IMAGE_ID = 1;
+
+
+        void destroy(const T* obj) noexcept
+        {
+            if(!obj)
+                return;
+
+            destroy_obj(obj);
+            POOL_PROBE(destroy, this, obj, this->size());
+        }
+
+
+        void destroy_n(T* const* objs, std::size_t n) noexcept
+        {
+            for(std::size_t i = 0; i < n; i++)
+                destroy(objs[i]);
+        }
+
+
+        template <typename UnaryFunction>
+        void for_each(UnaryFunction f)
+        {
+            if(this->empty())
+                return;
+
+            //guard if user will delete obj(for current i) from pool: search from i + 1
+            for(auto i = m_used.find_next(0); i < N; i = m_used.find_next(i + 1))
+                f((T *)&m_pool[i]);
+        }
+
+
+        void destroy_all() noexcept
+        {
+            if constexpr( !std::is_trivially_destructible_v<T> || pool_handles(Flags) )
+                for_each([this](T* obj){ std::destroy_at(obj); this->node_freed((const Node*)obj); });
+
+            m_used.reset();
+            m_full.reset();
+            this->m_size = 0;
+        }
+
+
+        using iterator               = Iterator_bitset<SPool_bitmap, T, N>;
+        using const_iterator         = Iterator_bitset<SPool_bitmap, const T, N>;
+        using reverse_iterator       = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        constexpr auto begin() noexcept       { return iterator(this, 0); }
+        constexpr auto end()   noexcept       { return iterator(this, N); }
+
+        constexpr auto begin() const noexcept { return const_iterator(this, 0); }
+        constexpr auto end()   const noexcept { return const_iterator(this, N); }
+        constexpr auto cbegin()const noexcept { return const_iterator(this, 0); }
+        constexpr auto cend()  const noexcept { return const_iterator(this, N); }
+
+        constexpr auto rbegin() noexcept       { return reverse_iterator(end());   }
+        constexpr auto rend()   noexcept       { return reverse_iterator(begin()); }
+
+        constexpr auto rbegin() const noexcept { return const_reverse_iterator(end());   }
+        constexpr auto rend()   const noexcept { return const_reverse_iterator(begin()); }
+        constexpr auto crbegin()const noexcept { return const_reverse_iterator(cend());  }
+        constexpr auto crend()  const noexcept { return const_reverse_iterator(cbegin());}
+
+        iterator destroy(const_iterator pos) noexcept
+        {
+            auto ret = pos;
+            ++ret;
+            destroy(&(*pos));
+            return ret;
+        }
+
+
+        iterator destroy(const_iterator first, const_iterator last) noexcept
+        {
+            while (first != last)
+              first = destroy(first);
+
+            return last;
+        }
+
+
+    private:
+        using Node   = struct { alignas(pool_data_align(Align, Flags)) std::byte data[sizeof(T)]; };
+        using Bitmap = word_bitset<N>;
+
+        std::array<Node, N>          m_pool;
+        Bitmap                       m_used; //0 - free, 1 - is used
+        word_bitset<Bitmap::WORDS>   m_full; //1 - the word of m_used is full
+
+
+        template <typename... Args>
+        T* create_obj(Args&&... args) noexcept(is_nothrow_create<T, Args...>)
+        {
+            auto i = find_free_node();
+
+            if(i == N)
+                return nullptr;
+
+            auto obj = ::new ((void *)&m_pool[i]) T(std::forward<Args>(args)...);
+
+            //---- Kalb line ----
+            mark_used(i);
+
+            return obj;
+        }
+
+        template <typename... Args>
+        std::size_t create_n_obj(T** objs, std::size_t n, const Args&... args)
+        {
+            create_n_saver<T, SPool_bitmap> saver{*this, objs};
+
+            while(saver.n < n)
+            {
+                auto i = find_free_node();
+
+                if(i == N)
+                    break;
+
+                mark_used(i);
+                objs[saver.n++] = (T *)&m_pool[i];
+
+                ::new ((void *)&m_pool[i]) T(args...);
+                saver.cnt++;
+            }
+
+            return saver.cnt;
+        }
+
+        void destroy_obj(const T* obj) noexcept
+        {
+            std::destroy_at(obj);
+            release_node(obj);
+        }
+
+        //Returns the node (without object) to the pool
+        void release_node(const T* obj) noexcept
+        {
+            auto i = index_node((const Node*)obj);
+
+            m_used.reset(i);
+            m_full.reset(i / Bitmap::BITS);
+            this->m_size--;
+            this->node_freed(&m_pool[i]);
+        }
+
+        //Returns all nodes to the pool (the objects are destroyed)
+        void release_all() noexcept
+        {
+            if constexpr(pool_handles(Flags))
+                for_each([this](T* obj){ this->node_freed((const Node*)obj); });
+
+            m_used.reset();
+            m_full.reset();
+            this->m_size = 0;
+        }
+
+        void mark_used(std::size_t i) noexcept
+        {
+            m_used.set(i);
+
+            if(m_used.word_full(i / Bitmap::BITS))
+                m_full.set(i / Bitmap::BITS);
+
+            this->m_size++;
+            this->node_taken(&m_pool[i]);
+        }
+
+        static T* get_obj(Node* node) noexcept { return (T *)node; }
+
+        //Returns the index of the first free node, or N if the pool is full
+        std::size_t find_free_node() const noexcept
+        {
+            auto w = m_full.find_first_zero();
+
+            if(w == Bitmap::WORDS)
+                return N;
+
+            return w * Bitmap::BITS + ctz64(~m_used.words[w]);
+        }
+
+        constexpr std::size_t index_node(const Node* node) const noexcept {
+            return std::distance(m_pool.cbegin(), node);
+        }
+
+        template <class, class, std::size_t> friend class Iterator_bitset;
+        friend create_n_saver<T, SPool_bitmap>;
+        friend Pool_base    <T, N, Align, Flags, SPool_bitmap>;
+        friend SPool_base   <T, N, Align, Flags, SPool_bitmap>;
+        friend SPool_handles<T, N, Flags, SPool_bitmap>;
+};
+
+
+
+
+
+//POOL_SPLIT_NODES: the links of nodes in the array parallel to m_pool
+template <typename Link, std::size_t N>
+struct SPool_split_links
+{
+    std::array<Link, N> m_links;
+};
+
+struct SPool_no_links {};
+
+
+
+
+// Static object pool is implemented on a circular doubly-linked list
+// (POOL_SPLIT_NODES: the links are in m_links, the index of link is the index of node)
+template <typename     T,
+          std::size_t  N,
+          std::size_t  Align = alignof(T),
+          Pool_flags_t Flags = 0>
+class SPool_dlist: public SPool_base<T, N, Align, Flags,
+                                     SPool_dlist<T, N, Align, Flags> >,
+                   public Pool_dlist_base<T, N, Align, Flags,
+                                          SPool_dlist<T, N, Align, Flags> >,
+                   private SPool_bump_index<N>,
+                   private std::conditional_t<(Flags & POOL_SPLIT_NODES) != 0,
+                                              SPool_split_links<typename Pool_dlist_base<T, N, Align, Flags,
+                                                                SPool_dlist<T, N, Align, Flags> >::Link, N>,
+                                              SPool_no_links>
+{
+    public:
+        SPool_dlist() = default;
+
+
+    private:
+        using Base = Pool_dlist_base<T, N, Align, Flags, SPool_dlist>;
+        using Node = typename Base::Node;
+        using Link = typename Base::Link;
+
+        std::array<Node, N> m_pool;
+
+        Link* split_link(Node* node) noexcept { return &this->m_links[node - m_pool.data()]; }
+        Node* split_node(Link* link) noexcept { return &m_pool[link - this->m_links.data()]; }
+
+
+        template <typename... Args>
+        T* create_obj(Args&&... args) noexcept(is_nothrow_create<T, Args...>)
+        {
+            bump_nodes(1);
+            return Base::create_obj(std::forward<Args>(args)...);
+        }
+
+        template <typename... Args>
+        std::size_t create_n_obj(T** objs, std::size_t n, const Args&... args)
+        {
+            bump_nodes(n);
+            return Base::create_n_obj(objs, n, args...);
+        }
+
+        //The free list gets the untouched nodes (see SPool_bump_index)
+        void bump_nodes(std::size_t n) noexcept
+        {
+            if(const auto cnt = this->bump(n, this->size()))
+            {
+                if constexpr(pool_handles(Flags))
+                    this->init_gens(this->m_bump - cnt, cnt);
+
+                this->add_to_free_nodes(&m_pool[this->m_bump - cnt], cnt);
+            }
+        }
+
+        friend Pool_base      <T, N, Align, Flags, SPool_dlist>;
+        friend SPool_base     <T, N, Align, Flags, SPool_dlist>;
+        friend Pool_dlist_base<T, N, Align, Flags, SPool_dlist>;
+        friend SPool_handles  <T, N, Flags, SPool_dlist>;
+};
+
+
+
+
+
+
+//The smallest unsigned type for the indices 0..N (N is the end of list)
+template <std::size_t N>
+using pool_index_t = std::conditional_t<(N <= UINT16_MAX), std::uint16_t, std::uint32_t>;
+
+
+template <typename Index>
+struct Pool_index_link
+{
+    Index prev;
+    Index next; //the next free node for the free nodes
+};
+
+
+
+/*
+ *  Static object pool is implemented on a circular doubly-linked list of indices
+ *
+ *  Technical details:
+ *
+ *  It's the analogue of SPool_dlist, but the links of node (prev, next) are
+ *  the indices of nodes in m_pool of the smallest type for N (pool_index_t),
+ *  the index N is the head of the used list (m_head) and the end of the free list.
+ *  So the links take 4 bytes (uint16_t) or 8 bytes (uint32_t) instead of
+ *  16 bytes (two pointers) per node.
+ *  The pool doesn't contain pointers to itself, so it can be moved: the
+ *  live objects are moved to the same indices in the new pool and the links
+ *  are copied as is (the trivially copyable T are copied by memcpy).
+ *  The pool can be stored in the containers (std::vector, std::optional).
+ *
+ *  POOL_SPLIT_NODES: the links are placed in the separate array m_links,
+ *  m_pool contains only the objects (the stride is sizeof(T) rounded up to Align).
+ *  So the over-aligned objects don't waste the padding after the links
+ *  (T with Align = 64 takes 64 bytes instead of 128) and the cache lines of
+ *  objects don't contain the links: for_each reads the links from m_links
+ *  (16 links per cache line) and the objects only.
+ */
+template <typename     T,
+          std::size_t  N,
+          std::size_t  Align = alignof(T),
+          Pool_flags_t Flags = 0>
+class SPool_idlist: public SPool_base<T, N, Align, Flags,
+                                      SPool_idlist<T, N, Align, Flags> >,
+                    public std::conditional_t<(Flags & POOL_SPLIT_NODES) != 0,
+                                              SPool_split_links<Pool_index_link<pool_index_t<N>>, N>,
+                                              SPool_no_links>
+{
+    static_assert(N < UINT32_MAX, "N is too big for the 32-bit indices");
+
+    public:
+        SPool_idlist() noexcept
+        {
+            reset_nodes();
+        }
+
+        //The links are the indices: the bytes of pool are its snapshot (see pool_save)
+        static constexpr std::uint32_t IMAGE_ID = 2;
+
+
+        SPool_idlist(SPool_idlist&& other) noexcept(std::is_nothrow_move_constructible_v<T>):
+            SPool_idlist()
+        {
+            move_from(other);
+        }
+
+
+        SPool_idlist& operator=(SPool_idlist&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        {
+            if constexpr (Flags & POOL_SELF_MOVE_GUARD)
+            {
+                if(this == &other)
+                    return *this;
+            }
+
+            destroy_all();
+            move_from(other);
+            return *this;
+        }
+
+
+        void destroy(const T* obj) noexcept
+        {
+            if(!obj)
+                return;
+
+            destroy_obj(obj);
+            POOL_PROBE(destroy, this, obj, this->size());
+        }
+
+
+        void destroy_n(T* const* objs, std::size_t n) noexcept
+        {
+            for(std::size_t i = 0; i < n; i++)
+                destroy(objs[i]);
+        }
+
+
+        template <typename UnaryFunction>
+        void for_each(UnaryFunction f)
+        {
+            for(auto i = m_head.next; i != N; )
+            {
+                auto next = link(i).next; //guard if user will delete obj(for current i) from pool
+                f(get_obj(&m_pool[i]));
+                i = next;
+            }
+        }
+
+
+        void destroy_all() noexcept
+        {
+            for_each([this](T* obj){ this->destroy_obj(obj); });
+        }
+
+
+        template <class Value>
+        class Iterator_t: public Iterator_facade<Iterator_t<Value>, Value>
+        {
+            public:
+                explicit Iterator_t(const SPool_idlist *pool = nullptr, std::size_t index = N) noexcept:
+                    m_pool(const_cast<SPool_idlist *>(pool)), m_index(index) {}
+
+                template <class OtherValue>
+                Iterator_t(const Iterator_t<OtherValue> &other) noexcept:
+                    m_pool(other.m_pool), m_index(other.m_index) {}
+
+            private:
+                SPool_idlist *m_pool;
+                std::size_t   m_index;
+
+                template <class OtherValue>
+                bool equal(const Iterator_t<OtherValue> &other) const noexcept
+                {
+                    return m_index == other.m_index;
+                }
+
+                void increment() noexcept { m_index = m_pool->link(m_index).next; }
+                void decrement() noexcept { m_index = m_pool->link(m_index).prev; }
+                Value& dereference() const noexcept
+                {
+                    return *(Value *)get_obj(&m_pool->m_pool[m_index]);
+                }
+
+                template <class> friend class Iterator_t;
+                friend class Iterator_facade<Iterator_t, Value>;
+                friend class SPool_idlist;
+        };
+
+        using iterator               = Iterator_t<T>;
+        using const_iterator         = Iterator_t<const T>;
+        using reverse_iterator       = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        constexpr auto begin() noexcept       { return iterator(this, m_head.next); }
+        constexpr auto end()   noexcept       { return iterator(this, N          ); }
+
+        constexpr auto begin() const noexcept { return const_iterator(this, m_head.next); }
+        constexpr auto end()   const noexcept { return const_iterator(this, N          ); }
+        constexpr auto cbegin()const noexcept { return const_iterator(this, m_head.next); }
+        constexpr auto cend()  const noexcept { return const_iterator(this, N          ); }
+
+        constexpr auto rbegin() noexcept       { return reverse_iterator(end());   }
+        constexpr auto rend()   noexcept       { return reverse_iterator(begin()); }
+
+        constexpr auto rbegin() const noexcept { return const_reverse_iterator(end());   }
+        constexpr auto rend()   const noexcept { return const_reverse_iterator(begin()); }
+        constexpr auto crbegin()const noexcept { return const_reverse_iterator(cend());  }
+        constexpr auto crend()  const noexcept { return const_reverse_iterator(cbegin());}
+
+        iterator destroy(const_iterator pos) noexcept
+        {
+            iterator ret(this, link(pos.m_index).next);
+            destroy_obj(&(*pos));
+
+            return ret;
+        }
+
+
+        iterator destroy(const_iterator first, const_iterator last) noexcept
+        {
+            while (first != last)
+              first = destroy(first);
+
+            return last;
+        }
+
+
+    private:
+        static constexpr bool SPLIT = Flags & POOL_SPLIT_NODES;
+
+        using Index = pool_index_t<N>;
+        using Link  = Pool_index_link<Index>;
+        using Data  = struct { alignas(pool_data_align(Align, Flags)) std::byte data[sizeof(T)]; };
+
+        struct Link_node {
+            Link  link;
+            Data  data;
+        };
+
+        using Node = std::conditional_t<SPLIT, Data, Link_node>;
+
+        std::array<Node, N> m_pool;
+        Link                m_head;  //the head of the used list
+        Index               m_free;  //the head of the free list
+
+
+        template <typename... Args>
+        T* create_obj(Args&&... args) noexcept(is_nothrow_create<T, Args...>)
+        {
+            if(m_free == N)
+                return nullptr;
+
+            const Index i   = m_free;
+            auto        obj = ::new ((void *)get_obj(&m_pool[i])) T(std::forward<Args>(args)...);
+
+            //---- Kalb line ----
+            m_free = link(i).next;
+            push_back(i);
+            this->m_size++;
+            this->node_taken(&m_pool[i]);
+
+            return obj;
+        }
+
+        void destroy_obj(const T* obj) noexcept
+        {
+            this->m_size--;
+            std::destroy_at(obj);
+
+            const auto i = index_of(obj);
+            remove(i);                   //remove node from the used list
+            add_to_free_nodes(i);
+        }
+
+        //Takes up to n nodes from the free list in one walk
+        template <typename... Args>
+        std::size_t create_n_obj(T** objs, std::size_t n, const Args&... args)
+        {
+            std::size_t cnt = 0;
+
+            for(; cnt < n && m_free != N; cnt++)
+            {
+                const Index i = m_free;
+                m_free        = link(i).next;
+                objs[cnt]     = get_obj(&m_pool[i]);
+                this->node_taken(&m_pool[i]);
+            }
+
+            this->m_size += cnt;
+            create_n_saver<T, SPool_idlist> saver{*this, objs, cnt};
+
+            for(; saver.cnt < cnt; saver.cnt++)
+            {
+                auto obj = ::new ((void *)objs[saver.cnt]) T(args...);
+                push_back(index_of(obj));
+            }
+
+            return cnt;
+        }
+
+        //Returns the node (without object) to the free list
+        void release_node(const T* obj) noexcept
+        {
+            this->m_size--;
+            add_to_free_nodes(index_of(obj));
+        }
+
+        //Returns all nodes to the free list (the objects are destroyed)
+        void release_all() noexcept
+        {
+            for_each([this](T* obj){ this->release_node(obj); });
+            m_head = Link{Index(N), Index(N)};
+        }
+
+        static T* get_obj(Node* node) noexcept
+        {
+            if constexpr(SPLIT)
+                return (T *)node;
+            else
+                return (T *)&node->data;
+        }
+
+        Index index_of(const T* obj) const noexcept
+        {
+            return Index(((const std::byte *)obj - (const std::byte *)m_pool.data()) / sizeof(Node));
+        }
+
+        Link& node_link(std::size_t i) noexcept
+        {
+            if constexpr(SPLIT)
+                return this->m_links[i];
+            else
+                return m_pool[i].link;
+        }
+
+        //The index N is the head of the used list
+        Link& link(std::size_t i) noexcept { return i == N ? m_head : node_link(i); }
+
+        void push_back(Index i) noexcept
+        {
+            const Index tail = m_head.prev;
 
-        constexpr auto begin() const noexcept { return const_iterator(m_used_nodes.next); }
-        constexpr auto end()   const noexcept { return const_iterator(&m_used_nodes    ); }
-        constexpr auto cbegin()const noexcept { return const_iterator(m_used_nodes.next); }
-        constexpr auto cend()  const noexcept { return const_iterator(&m_used_nodes    ); }
+            node_link(i)     = Link{tail, Index(N)};
+            link(tail).next  = i;
+            m_head.prev      = i;
+        }
 
-        constexpr auto rbegin() noexcept       { return reverse_iterator(end());   }
-        constexpr auto rend()   noexcept       { return reverse_iterator(begin()); }
+        void remove(Index i) noexcept
+        {
+            const auto node = node_link(i);
 
-        constexpr auto rbegin() const noexcept { return const_reverse_iterator(end());   }
-        constexpr auto rend()   const noexcept { return const_reverse_iterator(begin()); }
-        constexpr auto crbegin()const noexcept { return const_reverse_iterator(cend());  }
-        constexpr auto crend()  const noexcept { return const_reverse_iterator(cbegin());}
+            link(node.prev).next = node.next;
+            link(node.next).prev = node.prev;
+        }
 
-        iterator destroy(const_iterator pos) noexcept
+        void add_to_free_nodes(Index i) noexcept
         {
-            iterator ret(pos.m_node->next);
-            destroy_obj(&(*pos));
+            node_link(i).next = m_free;
+            m_free            = i;
+            this->node_freed(&m_pool[i]);
+        }
 
-            return ret;
+        //All nodes are free (the nodes are taken in the order of index),
+        //the whole links are written: the moved pool copies them
+        void reset_nodes() noexcept
+        {
+            for(std::size_t i = 0; i < N; i++)
+                node_link(i) = Link{Index(N), Index(i + 1)};
+
+            m_head = Link{Index(N), Index(N)};
+            m_free = 0;
+        }
+
+        //This pool is empty, the other pool becomes empty
+        void move_from(SPool_idlist& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        {
+            //only the live objects are copied: the free nodes have no data
+            if constexpr(std::is_trivially_copyable_v<T>)
+            {
+                other.for_each([this, &other](T* obj) {
+                    std::memcpy(get_obj(&m_pool[other.index_of(obj)]), obj, sizeof(T));
+                });
+            }
+            else
+            {
+                //the links are copied after the objects: if ctor of object will
+                //thrown an exception, the moved objects are destroyed (this pool
+                //stays empty) and the other keeps its objects in moved-from state
+                struct Saver
+                {
+                    SPool_idlist &pool;
+                    SPool_idlist &other;
+                    Index         i; //the index of object which is moved now
+
+                    ~Saver() noexcept
+                    {
+                        if(i == N)
+                            return;
+
+                        for(auto j = other.m_head.next; j != i; j = other.link(j).next)
+                            std::destroy_at(get_obj(&pool.m_pool[j]));
+                    }
+                } saver{*this, other, other.m_head.next};
+
+                for(; saver.i != N; saver.i = other.link(saver.i).next)
+                    ::new ((void *)get_obj(&m_pool[saver.i])) T(std::move(*get_obj(&other.m_pool[saver.i])));
+            }
+
+            for(std::size_t i = 0; i < N; i++)
+                node_link(i) = other.node_link(i);
+
+            if constexpr(pool_handles(Flags))
+                this->m_gens = other.m_gens;
+
+            m_head       = other.m_head;
+            m_free       = other.m_free;
+            this->m_size = other.m_size;
+            this->stat_move(other);
+
+            other.destroy_all();
+        }
+
+        friend Pool_base    <T, N, Align, Flags, SPool_idlist>;
+        friend SPool_base   <T, N, Align, Flags, SPool_idlist>;
+        friend SPool_handles<T, N, Flags, SPool_idlist>;
+        friend create_n_saver<T, SPool_idlist>;
+};
+
+
+
+
+
+/*
+ *  Static object pool for the shared memory, it's implemented
+ *  on a lock-free singly-linked list of indices
+ *
+ *  Technical details:
+ *
+ *  It's the analogue of Pool_list_mt_base for the static pool: methods
+ *  create/destroy can be called concurrently, but the pool has no pointers.
+ *  The link of node is the index of the next free node (the index N is
+ *  the end of list), it's placed before the object. The head of free list
+ *  is one 64-bit word {index (low 32 bits), tag (high 32 bits)} updated
+ *  via CAS. The tag is changed on each update of the head, it's a protection
+ *  from the ABA problem.
+ *
+ *  So the pool doesn't depend on its address: it can be placed in the shared
+ *  memory (see Pool_mapped::create) and each process which maps it creates
+ *  and destroys the objects in place, without copies. The pointers to objects
+ *  are valid only in one process: the processes exchange the indices of
+ *  objects (index_of, at_index). The atomics must be lock-free (they are
+ *  address-free then), so m_size is the lock-free atomic too.
+ *
+ *  The list is never locked: if the process dies between create and destroy,
+ *  only its objects are lost. The pool doesn't store information about the
+ *  used nodes (as SPool_list), so the destructor doesn't destroy the objects:
+ *  the pool in the shared memory outlives the processes.
+ */
+template <typename     T,
+          std::size_t  N,
+          std::size_t  Align = alignof(T),
+          Pool_flags_t Flags = 0>
+class SPool_shared: public SPool_base<T, N, Align, Flags,
+                                      SPool_shared<T, N, Align, Flags>, std::atomic<std::size_t> >
+{
+    static_assert(N < UINT32_MAX, "N is too big for the 32-bit indices");
+    static_assert(!pool_handles(Flags), "The generations of handles aren't thread-safe");
+    static_assert(!(Flags & POOL_STATS), "The counters of statistics aren't thread-safe");
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free &&
+                  std::atomic<std::size_t>::is_always_lock_free &&
+                  std::atomic<pool_index_t<N>>::is_always_lock_free, "The shared pool needs the lock-free atomics");
+
+    public:
+        SPool_shared() noexcept
+        {
+            for(std::size_t i = 0; i < N; i++)
+                m_pool[i].next.store(Index(i + 1), std::memory_order_relaxed);
+        }
+
+        //The links are the indices: the bytes of pool are its image (see Pool_mapped)
+        static constexpr std::uint32_t IMAGE_ID = 3;
+
+
+        void destroy(const T* obj) noexcept
+        {
+            if(!obj)
+                return;
+
+            destroy_obj(obj);
+            POOL_PROBE(destroy, this, obj, this->size());
+        }
+
+
+        //Destroys n objects (nullptr are skipped),
+        //the nodes are returned to the free list via one CAS
+        void destroy_n(T* const* objs, std::size_t n) noexcept
+        {
+            Index       first = N;
+            Index       last  = N;
+            std::size_t cnt   = 0;
+
+            for(std::size_t i = 0; i < n; i++)
+            {
+                if(!objs[i])
+                    continue;
+
+                std::destroy_at(objs[i]);
+
+                const auto node = Index(index_of(objs[i]));
+                m_pool[node].next.store(first, std::memory_order_relaxed);
+                first           = node;
+
+                if(last == N)
+                    last = node;
+
+                cnt++;
+            }
+
+            if(!cnt)
+                return;
+
+            this->m_size.fetch_sub(cnt, std::memory_order_relaxed);
+            push_nodes(first, last);
+            POOL_PROBE(destroy_n, this, cnt, this->size());
+        }
+
+
+        //The index of object is the same in all processes (the pointer isn't)
+        std::size_t index_of(const T* obj) const noexcept
+        {
+            return std::size_t((const std::byte *)obj - (const std::byte *)&m_pool[0].data) / sizeof(Node);
+        }
+
+        //The object of index, or nullptr if the index is out of pool
+        T* at_index(std::size_t index) noexcept
+        {
+            return index < N ? get_obj(index) : nullptr;
+        }
+
+
+    private:
+        using Index = pool_index_t<N>;
+        using Data  = struct { alignas(pool_data_align(Align, Flags)) std::byte data[sizeof(T)]; };
+
+        //The link doesn't overlap the object: the other thread may still
+        //read the link of a node which has been taken and is being constructed
+        struct Node {
+            std::atomic<Index> next;
+            Data               data;
+        };
+
+        std::array<Node, N>        m_pool;
+        std::atomic<std::uint64_t> m_free{0}; //{index, tag}: all nodes are free
+
+
+        //RAII for return of node to the free list
+        //in case ctor of object will thrown an exception.
+        struct node_saver
+        {
+            SPool_shared* pool;
+            Index         node;
+
+            ~node_saver() noexcept { if(node != N) pool->push_nodes(node, node); }
+        };
+
+
+        template <typename... Args>
+        T* create_obj(Args&&... args) noexcept(is_nothrow_create<T, Args...>)
+        {
+            const auto node = pop_node();
+
+            if(node == N)
+                return nullptr;
+
+            node_saver saver{this, node};
+            auto obj    = ::new ((void *)get_obj(node)) T(std::forward<Args>(args)...);
+            saver.node  = Index(N); //ctor of object did not throw an exception, all ok
+
+            //---- Kalb line ----
+            this->m_size.fetch_add(1, std::memory_order_relaxed);
+
+            return obj;
+        }
+
+        void destroy_obj(const T* obj) noexcept
+        {
+            this->m_size.fetch_sub(1, std::memory_order_relaxed);
+            std::destroy_at(obj);
+
+            const auto node = Index(index_of(obj));
+            push_nodes(node, node);
+        }
+
+        //The nodes are taken one by one (see Pool_list_mt_base)
+        template <typename... Args>
+        std::size_t create_n_obj(T** objs, std::size_t n, const Args&... args)
+        {
+            create_n_saver<T, SPool_shared> saver{*this, objs};
+
+            while(saver.n < n)
+            {
+                const auto node = pop_node();
+
+                if(node == N)
+                    break;
+
+                objs[saver.n++] = get_obj(node);
+                this->m_size.fetch_add(1, std::memory_order_relaxed);
+
+                ::new ((void *)get_obj(node)) T(args...);
+                saver.cnt++;
+            }
+
+            return saver.cnt;
+        }
+
+        //Returns the node (without object) to the free list
+        void release_node(const T* obj) noexcept
+        {
+            this->m_size.fetch_sub(1, std::memory_order_relaxed);
+
+            const auto node = Index(index_of(obj));
+            push_nodes(node, node);
+        }
+
+        //This algorithm does not support the for_each method (see Pool_list_mt_base)
+        void destroy_all() noexcept {}
+
+        T* get_obj(Index node) noexcept { return (T *)&m_pool[node].data; }
+
+
+        static constexpr Index head_index(std::uint64_t head) noexcept
+        {
+            return Index(head & UINT32_MAX);
+        }
+
+        //The new head with the next tag
+        static constexpr std::uint64_t make_head(Index node, std::uint64_t head) noexcept
+        {
+            return ((head >> 32) + 1) << 32 | node;
+        }
+
+        Index pop_node() noexcept
+        {
+            auto head = m_free.load(std::memory_order_acquire);
+
+            while(head_index(head) != N)
+            {
+                const auto next = make_head(m_pool[head_index(head)].next.load(std::memory_order_relaxed), head);
+
+                if(m_free.compare_exchange_weak(head, next,
+                                                std::memory_order_acq_rel,
+                                                std::memory_order_acquire))
+                    break;
+            }
+
+            return head_index(head);
+        }
+
+        //push the chain first->...->last to the free list via one CAS
+        void push_nodes(Index first, Index last) noexcept
+        {
+            auto head = m_free.load(std::memory_order_relaxed);
+
+            do
+            {
+                m_pool[last].next.store(head_index(head), std::memory_order_relaxed);
+            }
+            while(!m_free.compare_exchange_weak(head, make_head(first, head),
+                                                std::memory_order_release,
+                                                std::memory_order_relaxed));
+        }
+
+        friend Pool_base    <T, N, Align, Flags, SPool_shared, std::atomic<std::size_t>>;
+        friend SPool_base   <T, N, Align, Flags, SPool_shared, std::atomic<std::size_t>>;
+        friend create_n_saver<T, SPool_shared>;
+};
+
+
+
+
+
+template <typename     T,
+          std::size_t  N,
+          std::size_t  Align,
+          Pool_flags_t Flags,
+          typename     AlgBase,
+          typename     AlocBase,
+          typename     Impl>
+class Pool_xxx: public DPool_base<T, N, Align, Flags, Impl,
+                                  typename AlgBase::counter_type>,
+                public AlgBase,
+                public AlocBase
+{
+    public:
+        Pool_xxx() = default;
+
+        explicit Pool_xxx(const typename AlocBase::source_type& source) noexcept:
+            AlocBase(source)
+        {}
+
+
+        Pool_xxx(Pool_xxx&& other) noexcept : Pool_xxx()
+        {
+            move_from(std::move((Impl &&)other));
+        }
+
+
+        Pool_xxx& operator=(Pool_xxx&& other) noexcept
+        {
+            return this->move_assign_operator(std::move((Impl &&)other));
+        }
+
+
+    protected:
+        using Node = typename AlgBase::Node; //resolve ambiguity with AlocBase::Node
+
+
+    private:
+        void dtor() noexcept
+        {
+            this->destroy_all();
+            AlocBase::dtor();
+        }
+
+        void move_from(Impl&& other) noexcept
+        {
+            AlgBase ::move_from(std::move(other));
+            AlocBase::move_from(std::move(other));
+            this->stat_move(other);
         }
 
+        friend AlgBase;
+        friend AlocBase;
+        friend Pool_dtor<Impl, Flags>;
+        friend DPool_base<T, N, Align, Flags, Impl, typename AlgBase::counter_type>;
+};
+
+
+
+
+
+// Helper class to reduce writing template parameters
+template <typename     T,
+          std::size_t  N,
+          std::size_t  Align,
+          Pool_flags_t Flags,
+          typename     AlgBase,
+          typename     Impl,
+          typename     Source>
+class Pool_xxx_node: public Pool_xxx<T, N, Align, Flags,
+                                     AlgBase,
+                                     Pool_node_allocator<AlgBase, Impl, Source>,
+                                     Impl>
+{
+    using Pool_xxx<T, N, Align, Flags,
+                   AlgBase,
+                   Pool_node_allocator<AlgBase, Impl, Source>,
+                   Impl>::Pool_xxx; //for using explicit ctors!
+};
+
+
+
+
+
+// Dynamic object pool is implemented on a singly-linked list
+template <typename     T,
+          std::size_t  N,
+          std::size_t  Align  = alignof(T),
+          Pool_flags_t Flags  = 0,
+          typename     Source = Pool_heap_source>
+class Pool_list: public Pool_xxx_node<T, N, Align, Flags,
+                                      Pool_list_base<T, N, Align, Flags,
+                                      Pool_list<T, N, Align, Flags, Source> >,
+                                      Pool_list<T, N, Align, Flags, Source>,
+                                      Source>
+{
+    using Pool_xxx_node<T, N, Align, Flags,
+                        Pool_list_base<T, N, Align, Flags, Pool_list>,
+                        Pool_list,
+                        Source>::Pool_xxx_node; //for using explicit ctors!
+};
+
+
+
+
+
+// Dynamic object pool is implemented on a circular doubly-linked list
+template <typename     T,
+          std::size_t  N,
+          std::size_t  Align  = alignof(T),
+          Pool_flags_t Flags  = 0,
+          typename     Source = Pool_heap_source>
+class Pool_dlist: public Pool_xxx_node<T, N, Align, Flags,
+                                       Pool_dlist_base<T, N, Align, Flags,
+                                       Pool_dlist<T, N, Align, Flags, Source> >,
+                                       Pool_dlist<T, N, Align, Flags, Source>,
+                                       Source>
+{
+    static_assert(!(Flags & POOL_SPLIT_NODES), "POOL_SPLIT_NODES isn't supported: the nodes are allocated one by one, use Pool_dlist_block");
+
+    using Pool_xxx_node<T, N, Align, Flags,
+                        Pool_dlist_base<T, N, Align, Flags, Pool_dlist>,
+                        Pool_dlist,
+                        Source>::Pool_xxx_node; //for using explicit ctors!
+};
 
-        iterator destroy(const_iterator first, const_iterator last) noexcept
-        {
-            while (first != last)
-              first = destroy(first);
 
-            return last;
-        }
 
 
-    protected:
-        using Data = struct { alignas(Align) std::byte data[sizeof(T)]; };
 
-        struct Node {
-            union {
-            Node       *next;
-            dlist_head  head;
-            };
-            Data        data;
-        };
+// Dynamic object pool is implemented on a lock-free singly-linked list
+template <typename     T,
+          std::size_t  N,
+          std::size_t  Align  = alignof(T),
+          Pool_flags_t Flags  = 0,
+          typename     Source = Pool_heap_source>
+class Pool_list_mt: public Pool_xxx_node<T, N, Align, Flags,
+                                         Pool_list_mt_base<T, N, Align, Flags,
+                                         Pool_list_mt<T, N, Align, Flags, Source> >,
+                                         Pool_list_mt<T, N, Align, Flags, Source>,
+                                         Source>
+{
+    using Pool_xxx_node<T, N, Align, Flags,
+                        Pool_list_mt_base<T, N, Align, Flags, Pool_list_mt>,
+                        Pool_list_mt,
+                        Source>::Pool_xxx_node; //for using explicit ctors!
+};
 
-        Node       *m_free_nodes{nullptr};
-        dlist_head  m_used_nodes;
 
 
-        template <typename... Args>
-        T* create_obj(Args&&... args) noexcept(is_nothrow_create<T, Args...>)
-        {
-            if(!m_free_nodes)
-                return nullptr;
 
-            auto free_node = m_free_nodes;
-            auto obj       = ::new (&free_node->data) T(std::forward<Args>(args)...);
 
-            //---- Kalb line ----
-            m_free_nodes = free_node->next;
-            m_used_nodes.push_back(&free_node->head);
-            impl().m_size++;
+// Helper class to reduce writing template parameters
+template <typename     T,
+          std::size_t  N,
+          std::size_t  Align,
+          Pool_flags_t Flags,
+          typename     AlgBase,
+          typename     Impl,
+          typename     Source>
+class Pool_xxx_block: public Pool_xxx<T, N, Align, Flags,
+                                      AlgBase,
+                                      Pool_block_allocator<N, Flags, AlgBase, Impl, Source>,
+                                      Impl>,
+                      public Pool_handles_base<T, Flags, Impl,
+                                               Pool_block_allocator<N, Flags, AlgBase, Impl, Source>>
+{
+    using Pool_xxx<T, N, Align, Flags,
+                   AlgBase,
+                   Pool_block_allocator<N, Flags, AlgBase, Impl, Source>,
+                   Impl>::Pool_xxx; //for using explicit ctors!
+};
 
-            return obj;
-        }
 
-        void destroy_obj(const T* obj) noexcept
-        {
-            impl().m_size--;
-            std::destroy_at(obj);
 
-            auto node = get_node(obj);
-            node->head.remove();         //remove node from m_used_nodes
-            add_to_free_nodes(node);
-        }
 
-        static constexpr Node* get_node(const T* obj) noexcept {
-            return (Node *)((char *)obj - offsetof(Node, data));
-        }
 
-        static constexpr void* get_data(const dlist_head* head) noexcept {
-            return ((char *)head + offsetof(Node, data));
-        }
+/*
+ *  Dynamic object pool is implemented on a singly-linked list
+ *
+ *  It's analogue of Pool_list, but memory is allocated in blocks of N nodes.
+ */
+template <typename     T,
+          std::size_t  N,
+          std::size_t  Align  = alignof(T),
+          Pool_flags_t Flags  = 0,
+          typename     Source = Pool_heap_source>
+class Pool_list_block: public Pool_xxx_block<T, N, Align, Flags,
+                                             Pool_list_base<T, N, Align, Flags,
+                                             Pool_list_block<T, N, Align, Flags, Source> >,
+                                             Pool_list_block<T, N, Align, Flags, Source>,
+                                             Source>
+{
+    using Pool_xxx_block<T, N, Align, Flags,
+                         Pool_list_base<T, N, Align, Flags, Pool_list_block>,
+                         Pool_list_block,
+                         Source>::Pool_xxx_block; //for using explicit ctors!
+};
 
-        constexpr Node* top_free_node()    noexcept { return m_free_nodes;   }
-        constexpr void  reset_free_nodes() noexcept { m_free_nodes = nullptr;}
 
-        //If m_free_nodes == nullptr calling pop_free_node is undefined
-        constexpr void pop_free_node() noexcept
-        {
-            auto free_node = m_free_nodes;
-            m_free_nodes   = free_node->next;
-        }
 
-        constexpr void add_to_free_nodes(Node* node) noexcept
-        {
-            node->next   = m_free_nodes;
-            m_free_nodes = node;
-        }
 
-        constexpr void add_to_free_nodes(std::array<Node, N> &nodes) noexcept
-        {
-            for(auto &node: nodes)
-            {
-                add_to_free_nodes(&node);
-            }
-        }
 
+/*
+ *  Dynamic object pool is implemented on a circular doubly-linked list
+ *
+ *  It's analogue of Pool_dlist, but memory is allocated in blocks of N nodes.
+ */
+template <typename     T,
+          std::size_t  N,
+          std::size_t  Align  = alignof(T),
+          Pool_flags_t Flags  = 0,
+          typename     Source = Pool_heap_source>
+class Pool_dlist_block: public Pool_xxx_block<T, N, Align, Flags,
+                                              Pool_dlist_base<T, N, Align, Flags,
+                                              Pool_dlist_block<T, N, Align, Flags, Source> >,
+                                              Pool_dlist_block<T, N, Align, Flags, Source>,
+                                              Source>
+{
+    using Pool_xxx_block<T, N, Align, Flags,
+                         Pool_dlist_base<T, N, Align, Flags, Pool_dlist_block>,
+                         Pool_dlist_block,
+                         Source>::Pool_xxx_block; //for using explicit ctors!
+};
 
-        void move_from(Impl&& other) noexcept //only for dynamic
-        {
-            impl().m_size       = other.m_size;
-            impl().m_capacity   = other.m_capacity;
-            impl().m_free_nodes = other.m_free_nodes;
-            impl().m_used_nodes.splice_front(&other.m_used_nodes);
 
-            other.m_size       = 0;
-            other.m_capacity   = 0;
-            other.m_free_nodes = nullptr;
-        }
 
 
-    private:
-        constexpr Impl& impl() { return *static_cast<Impl*>(this); }
 
-        friend Pool_node_allocator <Pool_dlist_base, Impl>;
-        friend Pool_block_allocator<N, Pool_dlist_base, Impl>;
+/*
+ *  Dynamic object pool is implemented on a lock-free singly-linked list
+ *
+ *  It's analogue of Pool_list_mt, but memory is allocated in blocks of N nodes.
+ */
+template <typename     T,
+          std::size_t  N,
+          std::size_t  Align  = alignof(T),
+          Pool_flags_t Flags  = 0,
+          typename     Source = Pool_heap_source>
+class Pool_list_block_mt: public Pool_xxx_block<T, N, Align, Flags,
+                                                Pool_list_mt_base<T, N, Align, Flags,
+                                                Pool_list_block_mt<T, N, Align, Flags, Source> >,
+                                                Pool_list_block_mt<T, N, Align, Flags, Source>,
+                                                Source>
+{
+    using Pool_xxx_block<T, N, Align, Flags,
+                         Pool_list_mt_base<T, N, Align, Flags, Pool_list_block_mt>,
+                         Pool_list_block_mt,
+                         Source>::Pool_xxx_block; //for using explicit ctors!
 };
 
 
 
 
-
 /*
- * A mixin class that implements a node management algorithm
- * based on a singly-linked list
+ *  Per-thread cache (magazine) in front of a dynamic pool
  *
  *  Technical details:
  *
- *  Each Node is a union of a pointer and a type T.
- *  Free nodes contain a pointer to the next free node.
- *  Creation is quick as all that is necessary
- *  is to return the address of the next free node.
- *  Destroying also very quick as the node's content is simply
- *  replaced with the address of the current next free node.
+ *  The shared pool (Impl) is protected by a mutex. Each thread holds its own
+ *  Magazine - a small fixed array of free nodes. Magazine::create/destroy
+ *  work only with this array, so most of the calls don't touch the shared
+ *  memory. The shared pool is used only when the magazine is empty (refill)
+ *  or full (flush) - nodes are moved by batches of MagSize/2 nodes.
+ *
+ *  The nodes held by magazines are counted as used in the shared pool,
+ *  so size() includes them and shrink_to_fit never releases them.
+ *  Objects created via magazines are not linked to the list of used nodes
+ *  (for dlist algorithms), so there are no for_each/iterators and the user
+ *  must destroy all objects before the destructor is called (like P_l).
+ *  All magazines must be flushed (destructor of Magazine does it)
+ *  before the destructor of the shared pool is called.
  */
 template <typename     T,
           std::size_t  N,
           std::size_t  Align,
           Pool_flags_t Flags,
-          class        Impl>
-class Pool_list_base
+          template<typename, std::size_t, std::size_t, Pool_flags_t, typename...> class Impl,
+          std::size_t  MagSize>
+class Pool_magazine: private Impl<T, N, Align, Flags>
 {
+    static_assert(MagSize >= 2, "MagSize must be at least 2");
+
+    using Base = Impl<T, N, Align, Flags>;
+    using Node = typename Base::Node;
+
+    static constexpr std::size_t BATCH = MagSize / 2;
+
     public:
-        void destroy(const T* obj) noexcept
+        using value_type = T;
+        using size_type  = std::size_t;
+
+        static constexpr std::size_t MAGAZINE_SIZE = MagSize;
+
+        Pool_magazine() = default;
+
+
+        class Magazine
         {
-            if(obj)
-                destroy_obj(obj);
-        }
+            public:
+                explicit Magazine(Pool_magazine &pool) noexcept: m_pool(pool) {}
+                ~Magazine() noexcept { flush(); }
 
+                Magazine(const Magazine&)            = delete;
+                Magazine& operator=(const Magazine&) = delete;
 
-    protected:
-        using Data = struct { alignas(Align) std::byte data[sizeof(T)]; };
 
-        union Node {
-            Node* next;
-            Data  data;
-        };
+                template <typename... Args>
+                T* create(Args&&... args) noexcept(is_nothrow_create<T, Args...>)
+                {
+                    if(!m_count && !m_pool.refill(*this))
+                        return nullptr;
 
-        Node* m_free_nodes{nullptr};
+                    auto node = m_nodes[m_count - 1];
+                    auto obj  = ::new (&node->data) T(std::forward<Args>(args)...);
 
+                    //---- Kalb line ----
+                    m_count--;
 
-        template<class S>
-        class state_saver
-        {
-            private:
-                S  stored_value;
-                S& obj_ref;
+                    return obj;
+                }
 
-            public:
-                state_saver(S& object) noexcept:
-                    stored_value(object),
-                    obj_ref(object)
-                {}
 
-                ~state_saver() noexcept { if (enable) obj_ref = stored_value; }
+                void destroy(const T* obj) noexcept
+                {
+                    if(!obj)
+                        return;
 
-                bool enable{true};
-        };
+                    std::destroy_at(obj);
 
+                    if(m_count == MagSize)
+                        m_pool.flush(*this, BATCH);
 
-        template <typename... Args>
-        T* create_obj(Args&&... args) noexcept(is_nothrow_create<T, Args...>)
-        {
-            if(!m_free_nodes)
-                return nullptr;
+                    m_nodes[m_count++] = (Node *)((char *)obj - offsetof(Node, data));
+                }
 
-            auto next_node = m_free_nodes->next;
 
-            //Saver is a RAII for restore of state(linked list)
-            //in case ctor of object will thrown an exception.
-            //It is needed for basic exception guarantee.
-            //INFO: Some MSVC and mingw32 gcc version 7.3.0
-            //get internal compiler error:(for Auto Type Deduction for state_saver)
-            //The solution is to set the type manually
-            state_saver<Node*> saver(m_free_nodes->next);
-            auto obj     = ::new (m_free_nodes) T(std::forward<Args>(args)...);
-            saver.enable = false; //ctor of object did not throw an exception, all ok
+                //Returns all cached nodes to the shared pool (call it at thread exit)
+                void flush() noexcept { m_pool.flush(*this, m_count); }
 
-            //---- Kalb line ----
-            impl().m_size++;
-            m_free_nodes = next_node;
+                std::size_t count() const noexcept { return m_count; }
 
-            return obj;
-        }
 
-        void destroy_obj(const T* obj) noexcept
-        {
-            impl().m_size--;
-            std::destroy_at(obj);
+            private:
+                Pool_magazine              &m_pool;
+                std::array<Node*, MagSize>  m_nodes;
+                std::size_t                 m_count{0};
 
-            add_to_free_nodes((Node*)obj);
-        }
+                friend class Pool_magazine;
+        };
 
-        //This algorithm does not support the for_each method and,
-        //as a consequence, the destroy_all method. But we declare it empty
-        //so that we can call it in the derived (if necessary).
-        //We can use SFINAE test to check if a method destroy_all() exists
-        //but this is more code than just declaring a non-public empty method
-        //that will be removed by the compiler.
-        void destroy_all() noexcept {}
 
-        constexpr void add_to_free_nodes(Node* node) noexcept
+        std::size_t size() noexcept
         {
-            node->next   = m_free_nodes;
-            m_free_nodes = node;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return Base::size();
         }
 
-        constexpr void add_to_free_nodes(std::array<Node, N> &nodes) noexcept
+        std::size_t capacity() noexcept
         {
-            for(auto &node: nodes)
-            {
-                add_to_free_nodes(&node);
-            }
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return Base::capacity();
         }
 
-        constexpr Node* top_free_node()    noexcept { return m_free_nodes;   }
-        constexpr void  reset_free_nodes() noexcept { m_free_nodes = nullptr;}
-
-        //If m_free_nodes == nullptr calling pop_free_node is undefined
-        constexpr void pop_free_node() noexcept
+        void reserve(std::size_t new_cap) noexcept( !(Flags & POOL_RESERVE_EXCEPTION) )
         {
-            auto free_node = m_free_nodes;
-            m_free_nodes   = free_node->next;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            Base::reserve(new_cap);
         }
 
-
-        void move_from(Impl&& other) noexcept //only for dynamic
+        void shrink_to_fit(std::size_t new_cap = 0) noexcept
         {
-            impl().m_size       = other.m_size;
-            impl().m_capacity   = other.m_capacity;
-            impl().m_free_nodes = other.m_free_nodes;
-
-            other.m_size        = 0;
-            other.m_capacity    = 0;
-            other.m_free_nodes  = nullptr;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            Base::shrink_to_fit(new_cap);
         }
 
 
     private:
-        constexpr Impl& impl() { return *static_cast<Impl*>(this); }
+        std::mutex m_mutex;
 
-        friend Pool_node_allocator <Pool_list_base, Impl>;
-        friend Pool_block_allocator<N, Pool_list_base, Impl>;
-};
 
+        bool refill(Magazine &mag) noexcept
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
 
+            std::size_t cnt = 0;
 
+            while(cnt < BATCH)
+            {
+                if(!this->top_free_node())
+                {
+                    if constexpr(Flags & POOL_FIXED_CAPACITY)
+                        break;
 
+                    this->add_node();
 
-/*
- *  Static object pool is implemented on a singly-linked list
- *
- *  Technical details:
- *
- *  We don't store information(list) of the used nodes.
- *  This gives a lot of complexity == O(N^2) for the for_each algorithm.
- */
-template <typename     T,
-          std::size_t  N,
-          std::size_t  Align = alignof(T),
-          Pool_flags_t Flags = 0>
-class SPool_list: public SPool_base<T, N, Align, Flags,
-                                    SPool_list<T, N, Align, Flags> >,
-                  public Pool_list_base<T, N, Align, Flags,
-                                        SPool_list<T, N, Align, Flags> >
-{
-    public:
-        SPool_list() noexcept
-        {
-            this->add_to_free_nodes(m_pool);
-        }
+                    if(!this->top_free_node())
+                        break;
+                }
 
+                mag.m_nodes[mag.m_count++] = this->top_free_node();
+                this->pop_free_node();
+                cnt++;
+            }
 
-        template <typename UnaryFunction>
-        void for_each(UnaryFunction f)
-        {
-            if(this->empty())
-                return;
+            this->m_size += cnt;
 
+            return cnt != 0;
+        }
 
-            if(this->full()) //complexity == O(N)
-            {
-                for(auto &node : m_pool)
-                    f((T *)&node);
 
+        //Returns the n oldest(coldest) nodes of the magazine to the shared pool
+        void flush(Magazine &mag, std::size_t n) noexcept
+        {
+            if(!n)
                 return;
-            }
 
-            //The pool is not empty and not full, we have no information
-            //about the nodes used. But there is a list of free ones,
-            //this check leads to the complexity == O(N^2)
-            for(auto &node : m_pool)
             {
-                if(node_is_used(&node))
-                    f((T *)&node);
-            }
-        }
+                std::lock_guard<std::mutex> lock(m_mutex);
 
+                for(std::size_t i = 0; i < n; i++)
+                    this->add_to_free_nodes(mag.m_nodes[i]);
 
-        void destroy_all() noexcept
-        {
-            for_each([this](T* obj){ this->destroy_obj(obj); });
+                this->m_size -= n;
+            }
+
+            std::copy(mag.m_nodes.begin() + n, mag.m_nodes.begin() + mag.m_count, mag.m_nodes.begin());
+            mag.m_count -= n;
         }
+};
 
 
-    private:
-        using Node = typename Pool_list_base<T, N, Align, Flags, SPool_list>::Node;
 
-        std::array<Node, N> m_pool;
 
-        bool node_is_used(const Node* node) const noexcept
-        {
-            const Node* free_node = this->m_free_nodes;
 
-            while(free_node)
-            {
-                if(node == free_node)
-                    return false;
 
-                free_node = free_node->next;
-            }
 
-            return true;
-        }
+//The lookup table of the size classes: index - size in granules,
+//value - index of the first class which is big enough
+template <std::size_t Granule, std::size_t... Sizes>
+constexpr auto size_classes_lookup() noexcept
+{
+    constexpr std::size_t sizes[] = {Sizes...};
+    constexpr std::size_t max     = std::max({Sizes...});
 
-        friend SPool_base    <T, N, Align, Flags, SPool_list>;
-        friend Pool_list_base<T, N, Align, Flags, SPool_list>;
-        friend Pool_base     <T, N, Align, Flags, SPool_list>;
-};
+    std::array<std::uint8_t, max / Granule + 1> lookup{};
+    std::uint8_t cls = 0;
+
+    for(std::size_t i = 0; i < lookup.size(); i++)
+    {
+        while(sizes[cls] < i * Granule)
+            cls++;
 
+        lookup[i] = cls;
+    }
 
+    return lookup;
+}
 
 
 
 /*
- *  Static object pool is implemented on a singly-linked list + bitset
+ *  Size-class multi-pool (slab allocator) for raw memory
  *
  *  Technical details:
  *
- *  It's analogue of SPool_list, but we use bitset for the used nodes.
- *  This gives a complexity == O(N) for the for_each algorithm.
+ *  Each size class (Sizes) is a separate pool (Impl) of raw nodes of this size,
+ *  the alignment of nodes is the largest power of two which divides the size.
+ *  The request (bytes, align) is routed to the first class which is big enough
+ *  via the lookup table indexed by size in granules (8 bytes): complexity O(1).
+ *  The requests which are bigger than the largest class go to operator new.
+ *  deallocate() must get the same bytes and align as allocate()
+ *  (as std::pmr::memory_resource), they are used to find the class.
  */
-template <typename     T,
-          std::size_t  N,
-          std::size_t  Align = alignof(T),
-          Pool_flags_t Flags = 0>
-class SPool_list_bitset: public SPool_base<T, N, Align, Flags,
-                                           SPool_list_bitset<T, N, Align, Flags> >,
-                         public Pool_list_base<T, N, Align, Flags,
-                                               SPool_list_bitset<T, N, Align, Flags> >
+template <std::size_t  N,
+          Pool_flags_t Flags,
+          template<typename, std::size_t, std::size_t, Pool_flags_t, typename...> class Impl,
+          class        Sizes>
+class Pool_size_classes;
+
+
+template <std::size_t  N,
+          Pool_flags_t Flags,
+          template<typename, std::size_t, std::size_t, Pool_flags_t, typename...> class Impl,
+          std::size_t... Sizes>
+class Pool_size_classes<N, Flags, Impl, std::index_sequence<Sizes...>>
 {
+    static constexpr std::size_t GRANULE = 8;
+
+    static_assert(sizeof...(Sizes) > 0 && sizeof...(Sizes) < 256, "count of the size classes must be in [1, 255]");
+    static_assert(((Sizes % GRANULE == 0) && ...), "size classes must be multiples of 8");
+
     public:
-        SPool_list_bitset() noexcept
+        static constexpr std::size_t CLASSES  = sizeof...(Sizes);
+        static constexpr std::size_t MAX_SIZE = std::max({Sizes...});
+
+        Pool_size_classes() = default;
+
+        // disable copy/move semantics
+        Pool_size_classes(const Pool_size_classes&)            = delete;
+        Pool_size_classes& operator=(const Pool_size_classes&) = delete;
+
+
+        void* allocate(std::size_t bytes, std::size_t align = alignof(std::max_align_t))
         {
-            this->add_to_free_nodes(m_pool);
+            static constexpr std::array<void* (*)(Pool_size_classes&), CLASSES> create =
+                    make_table<void* (*)(Pool_size_classes&)>(
+                        [](auto I){ return &create_obj<I>; },
+                        std::make_index_sequence<CLASSES>());
+
+            auto cls = size_class(bytes, align);
+
+            if(cls == CLASSES)
+                return ::operator new(bytes, std::align_val_t(align), std::nothrow);
+
+            return create[cls](*this);
         }
 
 
-        template <typename... Args>
+        void deallocate(void* p, std::size_t bytes, std::size_t align = alignof(std::max_align_t)) noexcept
+        {
+            static constexpr std::array<void (*)(Pool_size_classes&, void*), CLASSES> destroy =
+                    make_table<void (*)(Pool_size_classes&, void*)>(
+                        [](auto I){ return &destroy_obj<I>; },
+                        std::make_index_sequence<CLASSES>());
+
+            if(!p)
+                return;
+
+            auto cls = size_class(bytes, align);
+
+            if(cls == CLASSES)
+                ::operator delete(p, std::align_val_t(align));
+            else
+                destroy[cls](*this, p);
+        }
+
+
+        //Creates an object of type T in the memory of its size class
+        template <typename T, typename... Args>
         T* create(Args&&... args) noexcept(is_nothrow_create<T, Args...>)
         {
-            if(!this->m_free_nodes)
-                return nullptr;
+            auto p = allocate(sizeof(T), alignof(T));
 
-            auto i   = index_node(this->m_free_nodes);
-            auto obj = this->create_obj(std::forward<Args>(args)...);
+            if(!p)
+                return nullptr;
 
-            //---- Kalb line ----
-            m_used[i] = 1;
+            memory_saver saver{this, p, sizeof(T), alignof(T)};
+            auto obj = ::new (p) T(std::forward<Args>(args)...);
+            saver.p  = nullptr; //ctor of object did not throw an exception, all ok
 
             return obj;
         }
 
 
+        template <typename T>
         void destroy(const T* obj) noexcept
         {
             if(!obj)
                 return;
 
-            auto i    = index_node((const Node*)obj);
-            m_used[i] = 0;
-            this->destroy_obj(obj);
+            std::destroy_at(obj);
+            deallocate(const_cast<T*>(obj), sizeof(T), alignof(T));
         }
 
 
-        template <typename UnaryFunction>
-        void for_each(UnaryFunction f)
+        //Returns the index of the class for the request (or CLASSES if it's too big)
+        static constexpr std::size_t size_class(std::size_t bytes, std::size_t align) noexcept
         {
-            if(this->empty())
-                return;
+            constexpr auto lookup = size_classes_lookup<GRANULE, Sizes...>();
 
-            for(std::size_t i = 0; i < N; i++)
-            {
-                if(m_used[i])
-                    f((T *)&m_pool[i]);
-            }
+            auto size = std::max(bytes, align);
+
+            if(size > MAX_SIZE)
+                return CLASSES;
+
+            std::size_t cls = lookup[(size + GRANULE - 1) / GRANULE];
+
+            while(cls < CLASSES && class_align(cls) < align) //for not power of two sizes
+                cls++;
+
+            return cls;
         }
 
+        static constexpr std::size_t class_size(std::size_t cls) noexcept
+        {
+            constexpr std::size_t sizes[] = {Sizes...};
+            return sizes[cls];
+        }
 
-        void destroy_all() noexcept
+        static constexpr std::size_t class_align(std::size_t cls) noexcept
         {
-            for_each([this](T* obj){ this->destroy_obj(obj); });
-            m_used.reset();
+            return node_align(class_size(cls));
         }
 
 
-        template <class Value>
-        class Iterator_t: public Iterator_facade<Iterator_t<Value>, Value>
+        template <std::size_t I>
+        constexpr auto&       pool()       noexcept { return std::get<I>(m_pools); }
+
+        template <std::size_t I>
+        constexpr const auto& pool() const noexcept { return std::get<I>(m_pools); }
+
+
+        //The count of the allocated nodes in all classes
+        std::size_t size() const noexcept
         {
-            public:
-                Iterator_t() noexcept: m_cur_pos(0), m_pool(nullptr) {}
+            return std::apply([](const auto&... pools){ return (pools.size() + ...); }, m_pools);
+        }
 
-                Iterator_t(const SPool_list_bitset *pool, std::size_t cur_pos) noexcept:
-                    m_cur_pos(cur_pos),
-                    m_pool(const_cast<SPool_list_bitset *>(pool))
-                {
-                    if(cur_pos != N)
-                        set_first_pos();
-                }
+        //The count of the nodes in all classes
+        std::size_t capacity() const noexcept
+        {
+            return std::apply([](const auto&... pools){ return (pools.capacity() + ...); }, m_pools);
+        }
 
-                //iterator to/from const_iterator
-                template <class OtherValue>
-                Iterator_t(const Iterator_t<OtherValue> &other) noexcept:
-                    m_cur_pos(other.m_cur_pos),
-                    m_pool(other.m_pool)
-                {}
+        void shrink_to_fit() noexcept
+        {
+            std::apply([](auto&... pools){ (pools.shrink_to_fit(), ...); }, m_pools);
+        }
 
-            private:
-                std::size_t        m_cur_pos;
-                SPool_list_bitset *m_pool;
 
-                template <class OtherValue>
-                bool equal(const Iterator_t<OtherValue> &other) const noexcept
-                {
-                    return m_cur_pos == other.m_cur_pos;
-                }
+    private:
+        static constexpr std::size_t node_align(std::size_t size) noexcept { return size & (~size + 1); }
 
-                void increment() noexcept { next(); }
-                void decrement() noexcept { prev(); }
-                Value& dereference() const noexcept { return (Value &)m_pool->m_pool[m_cur_pos]; }
+        template <std::size_t Size>
+        using Class_pool = Impl<Raw_storage<Size, node_align(Size)>, N, node_align(Size), Flags>;
 
-                void next() noexcept
-                {
-                    while(m_cur_pos < N)
-                    {
-                        m_cur_pos++;
+        std::tuple<Class_pool<Sizes>...> m_pools;
 
-                        if(m_pool->m_used[m_cur_pos])
-                            break;
-                    }
-                }
 
-                void prev() noexcept
-                {
-                    if(m_pool->empty())
-                    {
-                        m_cur_pos = N;
-                        return;
-                    }
+        //Returns the memory if ctor of object throws an exception
+        struct memory_saver
+        {
+            Pool_size_classes *pool;
+            void              *p;
+            std::size_t        bytes;
+            std::size_t        align;
 
-                    while(m_cur_pos > 0)
-                    {
-                        m_cur_pos--;
+            ~memory_saver() noexcept { if(p) pool->deallocate(p, bytes, align); }
+        };
 
-                        if(m_pool->m_used[m_cur_pos])
-                            return;
-                    }
 
-                    m_cur_pos = N;
-                }
+        template <std::size_t I>
+        static void* create_obj(Pool_size_classes& self)
+        {
+            return std::get<I>(self.m_pools).create();
+        }
 
-                void set_first_pos() noexcept
-                {
-                    if(m_pool->empty())
-                    {
-                        m_cur_pos = N;
-                        return;
-                    }
+        template <std::size_t I>
+        static void destroy_obj(Pool_size_classes& self, void* p) noexcept
+        {
+            using Storage = typename std::tuple_element_t<I, decltype(m_pools)>::value_type;
+            std::get<I>(self.m_pools).destroy(static_cast<Storage*>(p));
+        }
 
-                    m_cur_pos = 0;
+        template <typename F, typename Make, std::size_t... I>
+        static constexpr std::array<F, CLASSES> make_table(Make make, std::index_sequence<I...>) noexcept
+        {
+            return {{ make(std::integral_constant<std::size_t, I>())... }};
+        }
+};
 
-                    if(!m_pool->m_used[m_cur_pos])
-                        next();
-                }
 
-                template <class> friend class Iterator_t;
-                friend class Iterator_facade<Iterator_t, Value>;
-                friend class SPool_list_bitset;
-        };
 
-        using iterator               = Iterator_t<T>;
-        using const_iterator         = Iterator_t<const T>;
-        using reverse_iterator       = std::reverse_iterator<iterator>;
-        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
-        constexpr auto begin() noexcept       { return iterator(this, 0); }
-        constexpr auto end()   noexcept       { return iterator(this, N); }
 
-        constexpr auto begin() const noexcept { return const_iterator(this, 0); }
-        constexpr auto end()   const noexcept { return const_iterator(this, N); }
-        constexpr auto cbegin()const noexcept { return const_iterator(this, 0); }
-        constexpr auto cend()  const noexcept { return const_iterator(this, N); }
+/*
+ * The snapshot of pool in the file (trivially copyable T):
+ *
+ *  image   - the bytes of pool as is (SPool_bitmap, SPool_idlist, SPool_shared:
+ *            they have no pointers, the links are the indices), it's mapped back
+ *            by Pool_mapped and used in place.
+ *  objects - the live objects one by one (the other pools with iterators: the
+ *            block pools and SPool_dlist have the pointer links). It isn't
+ *            a fast restart: pool_load creates the objects again one by one.
+ *
+ * The header rejects the file of other pool (or of other binary): the image
+ * needs the same Impl, sizeof(T), Align, N, Flags and sizeof(pool), the objects
+ * need the same sizeof(T) and Align. The byte order isn't converted.
+ */
+struct Pool_snapshot_header
+{
+    char          magic[8];  //"POOLSNAP"
+    std::uint32_t version;
+    std::uint32_t image_id;  //Impl::IMAGE_ID for image, 0 for objects
+    std::uint64_t type_size;
+    std::uint64_t align;
+    std::uint64_t n;
+    std::uint64_t flags;
+    std::uint64_t pool_size;
+    std::uint64_t count;     //count of objects
+    std::uint64_t offset;    //offset of data in file
+};
 
-        constexpr auto rbegin() noexcept       { return reverse_iterator(end());   }
-        constexpr auto rend()   noexcept       { return reverse_iterator(begin()); }
+inline constexpr std::uint32_t POOL_SNAPSHOT_VERSION = 1;
 
-        constexpr auto rbegin() const noexcept { return const_reverse_iterator(end());   }
-        constexpr auto rend()   const noexcept { return const_reverse_iterator(begin()); }
-        constexpr auto crbegin()const noexcept { return const_reverse_iterator(cend());  }
-        constexpr auto crend()  const noexcept { return const_reverse_iterator(cbegin());}
 
-        iterator destroy(const_iterator pos) noexcept
-        {
-            auto ret = pos;
-            ++ret;
-            destroy(&(*pos));
-            return ret;
-        }
+template <class Pool, typename Enable = void>
+inline constexpr bool pool_has_image = false;
 
+template <class Pool>
+inline constexpr bool pool_has_image<Pool, std::void_t<decltype(Pool::IMAGE_ID)>> = true;
 
-        iterator destroy(const_iterator first, const_iterator last) noexcept
-        {
-            while (first != last)
-              first = destroy(first);
 
-            return last;
-        }
+template <class Pool>
+Pool_snapshot_header pool_snapshot_header(std::uint64_t count) noexcept
+{
+    using T = typename Pool::value_type;
+
+    static_assert(std::is_trivially_copyable_v<T>, "The snapshot needs the trivially copyable type");
+
+    Pool_snapshot_header header{};
+
+    std::memcpy(header.magic, "POOLSNAP", sizeof(header.magic));
+    header.version   = POOL_SNAPSHOT_VERSION;
+    header.type_size = sizeof(T);
+    header.align     = Pool::ALIGN;
+    header.count     = count;
+
+    if constexpr(pool_has_image<Pool>)
+    {
+        header.image_id  = Pool::IMAGE_ID;
+        header.n         = Pool::N_VALUE;
+        header.flags     = Pool::FLAGS;
+        header.pool_size = sizeof(Pool);
+        header.offset    = (sizeof(header) + alignof(Pool) - 1) / alignof(Pool) * alignof(Pool);
+    }
+    else
+    {
+        header.offset    = (sizeof(header) + alignof(T) - 1) / alignof(T) * alignof(T);
+    }
+
+    return header;
+}
 
 
-    private:
-        using Node = typename Pool_list_base<T, N, Align, Flags,
-                                             SPool_list_bitset>::Node;
+//The header is of this pool (count isn't checked)
+template <class Pool>
+bool pool_snapshot_check(const Pool_snapshot_header& header) noexcept
+{
+    auto expected = pool_snapshot_header<Pool>(header.count);
 
-        std::array<Node, N> m_pool;
-        std::bitset<N>      m_used; //0 - free, 1 - is used
+    return std::memcmp(&expected, &header, sizeof(header)) == 0;
+}
 
-        constexpr std::size_t index_node(const Node* node) const noexcept {
-            return std::distance(m_pool.cbegin(), node);
-        }
 
-        friend Pool_list_base<T, N, Align, Flags, SPool_list_bitset>;
-};
+//Writes the snapshot of pool to the file: the image (SPool_bitmap, SPool_idlist,
+//SPool_shared) or the dump of live objects (the other pools with iterators, see
+//Pool_snapshot_header). Returns false on error.
+template <class Pool>
+bool pool_save(const Pool& pool, const char* path) noexcept
+{
+    auto file = std::fopen(path, "wb");
 
+    if(!file)
+        return false;
 
+    const auto header = pool_snapshot_header<Pool>(pool.size());
+    bool       ok     = std::fwrite(&header, sizeof(header), 1, file) == 1;
 
+    for(auto i = sizeof(header); ok && i < header.offset; i++)
+        ok = std::fputc(0, file) != EOF;
 
+    if constexpr(pool_has_image<Pool>)
+    {
+        ok = ok && std::fwrite(&pool, sizeof(Pool), 1, file) == 1;
+    }
+    else
+    {
+        for(auto it = pool.begin(); ok && it != pool.end(); ++it)
+            ok = std::fwrite(&*it, sizeof(*it), 1, file) == 1;
+    }
 
-// Static object pool is implemented on a circular doubly-linked list
-template <typename     T,
-          std::size_t  N,
-          std::size_t  Align = alignof(T),
-          Pool_flags_t Flags = 0>
-class SPool_dlist: public SPool_base<T, N, Align, Flags,
-                                     SPool_dlist<T, N, Align, Flags> >,
-                   public Pool_dlist_base<T, N, Align, Flags,
-                                          SPool_dlist<T, N, Align, Flags> >
+    ok = (std::fflush(file) == 0) && ok;
+
+    return (std::fclose(file) == 0) && ok;
+}
+
+
+//The offset over 2 GiB doesn't fit into long of LLP64 (Windows)
+inline int pool_fseek(std::FILE* file, std::uint64_t offset) noexcept
 {
-    public:
-        SPool_dlist() noexcept
-        {
-            this->add_to_free_nodes(m_pool);
-        }
+#if defined(_WIN32)
+    return _fseeki64(file, static_cast<__int64>(offset), SEEK_SET);
+#elif defined(POOL_MMAP)
+    return fseeko(file, static_cast<off_t>(offset), SEEK_SET);
+#else
+    return offset <= std::uint64_t(LONG_MAX) ? std::fseek(file, long(offset), SEEK_SET) : -1;
+#endif
+}
 
 
-    private:
-        using Node = typename Pool_dlist_base<T, N, Align, Flags,
-                                              SPool_dlist>::Node;
+//Creates the objects of snapshot (pool_save) in the pool. Returns the count
+//of created objects (it's less than in the file if the pool is full).
+template <class Pool>
+std::size_t pool_load(Pool& pool, const char* path)
+{
+    using T = typename Pool::value_type;
 
-        std::array<Node, N> m_pool;
+    auto file = std::fopen(path, "rb");
 
-        friend Pool_base      <T, N, Align, Flags, SPool_dlist>;
-        friend SPool_base     <T, N, Align, Flags, SPool_dlist>;
-        friend Pool_dlist_base<T, N, Align, Flags, SPool_dlist>;
-};
+    if(!file)
+        return 0;
 
+    Pool_snapshot_header header;
+    std::size_t          cnt = 0;
 
+    if(std::fread(&header, sizeof(header), 1, file) == 1 &&
+       header.type_size == sizeof(T) && header.align == Pool::ALIGN &&
+       std::memcmp(header.magic, "POOLSNAP", sizeof(header.magic)) == 0 &&
+       header.version == POOL_SNAPSHOT_VERSION && !header.image_id &&
+       pool_fseek(file, header.offset) == 0)
+    {
+        alignas(T) unsigned char buf[sizeof(T)];
 
+        for(; cnt < header.count && std::fread(buf, sizeof(T), 1, file) == 1; cnt++)
+        {
+            if(!pool.create(*std::launder(reinterpret_cast<const T*>(buf))))
+                break;
+        }
+    }
 
+    std::fclose(file);
 
-template <typename     T,
-          std::size_t  N,
-          std::size_t  Align,
-          Pool_flags_t Flags,
-          typename     AlgBase,
-          typename     AlocBase,
-          typename     Impl>
-class Pool_xxx: public DPool_base<T, N, Align, Flags, Impl>,
-                public AlgBase,
-                public AlocBase
+    return cnt;
+}
+
+
+
+#if defined(POOL_MMAP)
+/*
+ * The image of pool (pool_save) mapped from the file: the pool is used in place,
+ * there is no construction and no copy (the pages are read on the first access).
+ *
+ *  writable == true  - the changes of pool go to the file (MAP_SHARED),
+ *                      the file is a persistent pool (see msync).
+ *  writable == false - the changes are private (copy-on-write), the file isn't changed.
+ *
+ * create() makes the new empty pool in the file (e.g. in /dev/shm or the fd of
+ * shm_open/memfd_create), the other processes open it (writable) and use it
+ * together if the pool is thread-safe (SPool_shared). The file must be opened
+ * after create() returns: the header is written the last.
+ *
+ * The pool isn't destroyed (its T is trivially copyable), the mapping is released.
+ */
+template <class Pool>
+class Pool_mapped
 {
+    static_assert(pool_has_image<Pool>, "The image of pool is for SPool_bitmap, SPool_idlist, SPool_shared");
+
     public:
-        Pool_xxx() = default;
+        Pool_mapped() = default;
 
+        Pool_mapped(const char* path, bool writable = false) noexcept { open(path, writable); }
 
-        Pool_xxx(Pool_xxx&& other) noexcept : Pool_xxx()
-        {
-            move_from(std::move((Impl &&)other));
-        }
+        ~Pool_mapped() noexcept { close(); }
 
+        Pool_mapped(Pool_mapped&& other) noexcept:
+            m_addr(std::exchange(other.m_addr, nullptr)),
+            m_size(std::exchange(other.m_size, 0))
+        {}
 
-        Pool_xxx& operator=(Pool_xxx&& other) noexcept
+        Pool_mapped& operator=(Pool_mapped&& other) noexcept
         {
-            return this->move_assign_operator(std::move((Impl &&)other));
+            if(this != &other)
+            {
+                close();
+                m_addr = std::exchange(other.m_addr, nullptr);
+                m_size = std::exchange(other.m_size, 0);
+            }
+
+            return *this;
         }
 
 
-    private:
-        void dtor() noexcept
+        //Returns the pool, or nullptr if the file isn't the image of this pool
+        Pool* open(const char* path, bool writable = false) noexcept
         {
-            this->destroy_all();
-            AlocBase::dtor();
+            close();
+
+            const int fd = ::open(path, writable ? O_RDWR : O_RDONLY);
+
+            if(fd < 0)
+                return nullptr;
+
+            open(fd, writable);
+            ::close(fd);
+
+            return get();
         }
 
-        void move_from(Impl&& other) noexcept
+        //The same for the opened file (the fd isn't closed)
+        Pool* open(int fd, bool writable = false) noexcept
         {
-            AlgBase ::move_from(std::move(other));
-            AlocBase::move_from(std::move(other));
-        }
+            close();
 
-        friend AlgBase;
-        friend AlocBase;
-        friend Pool_dtor<Impl, Flags>;
-        friend DPool_base<T, N, Align, Flags, Impl>;
-};
+            struct stat st;
+            Pool_snapshot_header header;
 
+            if(fstat(fd, &st) == 0 &&
+               pread(fd, &header, sizeof(header), 0) == ssize_t(sizeof(header)) &&
+               pool_snapshot_check<Pool>(header) &&
+               std::uint64_t(st.st_size) >= header.offset + sizeof(Pool))
+            {
+                map(fd, std::size_t(header.offset + sizeof(Pool)), writable ? MAP_SHARED : MAP_PRIVATE);
+            }
 
+            return get();
+        }
 
 
+        //Creates the empty pool in the file (the old content is removed), the mapping
+        //is shared. Returns the pool, or nullptr on error.
+        Pool* create(const char* path) noexcept
+        {
+            close();
 
-// Helper class to reduce writing template parameters
-template <typename     T,
-          std::size_t  N,
-          std::size_t  Align,
-          Pool_flags_t Flags,
-          typename     AlgBase,
-          typename     Impl>
-class Pool_xxx_node: public Pool_xxx<T, N, Align, Flags,
-                                     AlgBase,
-                                     Pool_node_allocator<AlgBase, Impl>,
-                                     Impl>
-{
-    using Pool_xxx<T, N, Align, Flags,
-                   AlgBase,
-                   Pool_node_allocator<AlgBase, Impl>,
-                   Impl>::Pool_xxx; //for using explicit ctors!
-};
+            const int fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0666);
 
+            if(fd < 0)
+                return nullptr;
 
+            create(fd);
+            ::close(fd);
 
+            return get();
+        }
 
+        //The same for the opened file (the fd isn't closed)
+        Pool* create(int fd) noexcept
+        {
+            close();
 
-// Dynamic object pool is implemented on a singly-linked list
-template <typename     T,
-          std::size_t  N,
-          std::size_t  Align = alignof(T),
-          Pool_flags_t Flags = 0>
-class Pool_list: public Pool_xxx_node<T, N, Align, Flags,
-                                      Pool_list_base<T, N, Align, Flags,
-                                      Pool_list<T, N, Align, Flags> >,
-                                      Pool_list<T, N, Align, Flags> >
-{
-    using Pool_xxx_node<T, N, Align, Flags,
-                        Pool_list_base<T, N, Align, Flags, Pool_list>,
-                        Pool_list>::Pool_xxx_node; //for using explicit ctors!
-};
+            const auto header = pool_snapshot_header<Pool>(0);
+            const auto size   = std::size_t(header.offset + sizeof(Pool));
 
+            if(ftruncate(fd, 0) != 0 || ftruncate(fd, off_t(size)) != 0 || !map(fd, size, MAP_SHARED))
+                return nullptr;
 
+            ::new (static_cast<std::byte*>(m_addr) + header.offset) Pool();
 
+            //the header is the last: the file with the header has the pool
+            std::atomic_thread_fence(std::memory_order_release);
+            std::memcpy(m_addr, &header, sizeof(header));
 
+            return get();
+        }
 
-// Dynamic object pool is implemented on a circular doubly-linked list
-template <typename     T,
-          std::size_t  N,
-          std::size_t  Align = alignof(T),
-          Pool_flags_t Flags = 0>
-class Pool_dlist: public Pool_xxx_node<T, N, Align, Flags,
-                                       Pool_dlist_base<T, N, Align, Flags,
-                                       Pool_dlist<T, N, Align, Flags> >,
-                                       Pool_dlist<T, N, Align, Flags> >
-{
-    using Pool_xxx_node<T, N, Align, Flags,
-                        Pool_dlist_base<T, N, Align, Flags, Pool_dlist>,
-                        Pool_dlist>::Pool_xxx_node; //for using explicit ctors!
-};
+        void close() noexcept
+        {
+            if(m_addr)
+                munmap(m_addr, m_size);
 
+            m_addr = nullptr;
+            m_size = 0;
+        }
 
+        //writable: writes the changes of pool to the file (else they are written by the system later)
+        bool sync() noexcept
+        {
+            return m_addr && msync(m_addr, m_size, MS_SYNC) == 0;
+        }
 
+        Pool* get() const noexcept
+        {
+            if(!m_addr)
+                return nullptr;
 
+            auto header = static_cast<const Pool_snapshot_header*>(m_addr);
 
-// Helper class to reduce writing template parameters
-template <typename     T,
-          std::size_t  N,
-          std::size_t  Align,
-          Pool_flags_t Flags,
-          typename     AlgBase,
-          typename     Impl>
-class Pool_xxx_block: public Pool_xxx<T, N, Align, Flags,
-                                      AlgBase,
-                                      Pool_block_allocator<N, AlgBase, Impl>,
-                                      Impl>
-{
-    using Pool_xxx<T, N, Align, Flags,
-                   AlgBase,
-                   Pool_block_allocator<N, AlgBase, Impl>,
-                   Impl>::Pool_xxx; //for using explicit ctors!
-};
+            return std::launder(reinterpret_cast<Pool*>(static_cast<std::byte*>(m_addr) + header->offset));
+        }
 
+        Pool* operator->() const noexcept { return  get(); }
+        Pool& operator*()  const noexcept { return *get(); }
 
+        explicit operator bool() const noexcept { return m_addr != nullptr; }
 
 
+    private:
+        void*       m_addr = nullptr;
+        std::size_t m_size = 0;
 
-/*
- *  Dynamic object pool is implemented on a singly-linked list
- *
- *  It's analogue of Pool_list, but memory is allocated in blocks of N nodes.
- */
-template <typename     T,
-          std::size_t  N,
-          std::size_t  Align = alignof(T),
-          Pool_flags_t Flags = 0>
-class Pool_list_block: public Pool_xxx_block<T, N, Align, Flags,
-                                             Pool_list_base<T, N, Align, Flags,
-                                             Pool_list_block<T, N, Align, Flags> >,
-                                             Pool_list_block<T, N, Align, Flags> >
-{
-    using Pool_xxx_block<T, N, Align, Flags,
-                         Pool_list_base<T, N, Align, Flags, Pool_list_block>,
-                         Pool_list_block>::Pool_xxx_block; //for using explicit ctors!
-};
+        bool map(int fd, std::size_t size, int flags) noexcept
+        {
+            auto addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, fd, 0);
 
+            if(addr == MAP_FAILED)
+                return false;
 
+            m_addr = addr;
+            m_size = size;
 
+            return true;
+        }
+};
+#endif // POOL_MMAP
 
 
-/*
- *  Dynamic object pool is implemented on a circular doubly-linked list
- *
- *  It's analogue of Pool_dlist, but memory is allocated in blocks of N nodes.
- */
-template <typename     T,
-          std::size_t  N,
-          std::size_t  Align = alignof(T),
-          Pool_flags_t Flags = 0>
-class Pool_dlist_block: public Pool_xxx_block<T, N, Align, Flags,
-                                              Pool_dlist_base<T, N, Align, Flags,
-                                              Pool_dlist_block<T, N, Align, Flags> >,
-                                              Pool_dlist_block<T, N, Align, Flags> >
-{
-    using Pool_xxx_block<T, N, Align, Flags,
-                         Pool_dlist_base<T, N, Align, Flags, Pool_dlist_block>,
-                         Pool_dlist_block>::Pool_xxx_block; //for using explicit ctors!
-};
 
 
 
@@ -1461,6 +5805,17 @@ using  pool_impl::POOL_FIXED_CAPACITY;
 using  pool_impl::POOL_SELF_MOVE_GUARD;
 using  pool_impl::POOL_CREATE_EXCEPTION;
 using  pool_impl::POOL_RESERVE_EXCEPTION;
+using  pool_impl::POOL_MMAP_BLOCKS;
+using  pool_impl::POOL_GROW_BLOCKS;
+using  pool_impl::POOL_TRIM_BLOCKS;
+using  pool_impl::POOL_FULLEST_BLOCK;
+using  pool_impl::POOL_HANDLES;
+using  pool_impl::POOL_HANDLES_64;
+using  pool_impl::POOL_SPLIT_NODES;
+using  pool_impl::POOL_CACHE_LINE;
+using  pool_impl::POOL_STATS;
+using  pool_impl::pool_grow_blocks_nodes;
+using  pool_impl::pool_grow_blocks_bytes;
 
 
 #define POOL_USING_ALIAS(alias_name, impl_name) \
@@ -1470,12 +5825,38 @@ using  pool_impl::POOL_RESERVE_EXCEPTION;
 
 POOL_USING_ALIAS(SPool_list       , SPool_list       )
 POOL_USING_ALIAS(SPool_list_bitset, SPool_list_bitset)
+POOL_USING_ALIAS(SPool_bitmap     , SPool_bitmap     )
 POOL_USING_ALIAS(SPool_dlist      , SPool_dlist      )
+POOL_USING_ALIAS(SPool_idlist     , SPool_idlist     )
+POOL_USING_ALIAS(SPool_shared     , SPool_shared     )
 
-POOL_USING_ALIAS(Pool_list        , Pool_list        )
-POOL_USING_ALIAS(Pool_list_block  , Pool_list_block  )
-POOL_USING_ALIAS(Pool_dlist       , Pool_dlist       )
-POOL_USING_ALIAS(Pool_dlist_block , Pool_dlist_block )
+//The dynamic pools have the memory source (see Pool_heap_source)
+#define POOL_USING_SOURCE_ALIAS(alias_name, impl_name) \
+    template <typename T, std::size_t N, std::size_t Align = alignof(T), Pool_flags_t Flags = 0, \
+              typename Source = pool_impl::Pool_heap_source> \
+    using alias_name = pool_impl::impl_name<T, N, Align, Flags, Source>;
+
+
+POOL_USING_SOURCE_ALIAS(Pool_list        , Pool_list        )
+POOL_USING_SOURCE_ALIAS(Pool_list_block  , Pool_list_block  )
+POOL_USING_SOURCE_ALIAS(Pool_dlist       , Pool_dlist       )
+POOL_USING_SOURCE_ALIAS(Pool_dlist_block , Pool_dlist_block )
+
+POOL_USING_SOURCE_ALIAS(Pool_list_mt      , Pool_list_mt      )
+POOL_USING_SOURCE_ALIAS(Pool_list_block_mt, Pool_list_block_mt)
+
+
+using pool_impl::Pool_heap_source;
+using pool_impl::Pool_buffer_source;
+using pool_impl::Pool_handle;
+using pool_impl::Pool_stats;
+using pool_impl::Pool_snapshot_header;
+using pool_impl::pool_save;
+using pool_impl::pool_load;
+
+#if defined(POOL_MMAP)
+using pool_impl::Pool_mapped;
+#endif
 
 
 
@@ -1491,33 +5872,42 @@ POOL_USING_ALIAS(Pool_dlist_block , Pool_dlist_block )
  *  Align - The alignment of items in the pool
  *  Flags - The is an extended flags to tuning of implementation
  *  Impl  - This is a specific implementation(algorithm) see below
+ *  Source - The memory source of dynamic Impl (Pool_heap_source by default,
+ *           Pool_buffer_source), it's optional
  *
  *  Abbreviations (Impl):
  *             Static         |       Dynamic
  *  --------------------------|--------------------------
  *  SP_l  - SPool_list        | P_l   - Pool_list
  *  SP_b  - SPool_list_bitset | P_dl  - Pool_dlist
- *  SP_dl - SPool_dlist       | P_lb  - Pool_list_block
- *                            | P_dlb - Pool_dlist_block
+ *  SP_bm - SPool_bitmap      | P_lb  - Pool_list_block
+ *  SP_dl - SPool_dlist       | P_dlb - Pool_dlist_block
+ *  SP_idl- SPool_idlist      | P_lmt - Pool_list_mt
+ *  SP_sh - SPool_shared      | P_lbm - Pool_list_block_mt
  *
  *  Algorithmic complexity:
  *
- *               |      Static          ||       Dynamic
- * --------------|----------------------||---------------------------
- *  method/Impl  | SP_l  | SP_b | SP_dl || P_l  | P_dl | P_lb | P_dlb
- * --------------|-------|------|-------||------|------|------|------
- *  destroy(iter)|   -   | O(1) | O(1)  ||  -   | O(1) |  -   | O(1)
- *  destroy(f, l)|   -   | O(N) | O(N)  ||  -   | O(N) |  -   | O(N)
- *  destroy_all  | O(N^2)| O(N) | O(N)  ||  -   | O(N) |  -   | O(N)
- *  for_each     | O(N^2)| O(N) | O(N)  ||  -   | O(N) |  -   | O(N)
- *  reserve      |   -   |   -  |   -   || O(N) | O(N) | O(N) | O(N)
- *  shrink_to_fit|   -   |   -  |   -   || O(N) | O(N) | O(N) | O(N)
- *  constructor  | O(N)  | O(N) | O(N)  || O(1) | O(1) | O(1) | O(1)
- *  destructor   | O(N^2)| O(N) | O(N)  || O(N) | O(N) | O(N) | O(N)
- *  iterator     |   -   | Bid  | Bid   ||  -   | Bid  |  -   | Bid
+ *               |              Static                  ||       Dynamic
+ * --------------|--------------------------------------||---------------------------
+ *  method/Impl  | SP_l  | SP_b | SP_bm | SP_dl | SP_idl|| P_l  | P_dl | P_lb | P_dlb
+ * --------------|-------|------|-------|-------|-------||------|------|------|------
+ *  destroy(iter)|   -   | O(1) | O(1)  | O(1)  | O(1)  ||  -   | O(1) |  -   | O(1)
+ *  destroy(f, l)|   -   | O(N) | O(N)  | O(N)  | O(N)  ||  -   | O(N) |  -   | O(N)
+ *  destroy_all  | O(N^2)| O(N) | O(N)  | O(N)  | O(N)  ||  -   | O(N) |  -   | O(N)
+ *  for_each     | O(N^2)| O(N) | O(N)  | O(N)  | O(N)  ||  -   | O(N) |  -   | O(N)
+ *  parallel_xxx |   -   | O(N) | O(N)  | O(N)  | O(N)  ||  -   | O(N) |  -   | O(N)
+ *  reserve      |   -   |   -  |   -   |   -   |   -   || O(N) | O(N) | O(N) | O(N)
+ *  shrink_to_fit|   -   |   -  |   -   |   -   |   -   || O(N) | O(N) | O(N) | O(N)
+ *  compact      |   -   |   -  |   -   |   -   |   -   ||  -   |  -   |  -   | O(N)
+ *  constructor  | O(1)  | O(1) | O(1)  | O(1)  | O(N)  || O(1) | O(1) | O(1) | O(1)
+ *  destructor   | O(N^2)| O(N) | O(N)  | O(N)  | O(N)  || O(N) | O(N) | O(N) | O(N)
+ *  move         |   -   |   -  |   -   |   -   | O(N)  || O(1) | O(1) | O(1) | O(1)
+ *  iterator     |   -   | Bid  | Bid   | Bid   | Bid   ||  -   | Bid  |  -   | Bid
  *
  *  All base methods have complexity is O(1)!
  *  It's methods: size, capacity, empty, full, create, destroy(T*)
+ *  (Pool_xxx_block with POOL_GROW_BLOCKS and POOL_TRIM_BLOCKS, POOL_FULLEST_BLOCK
+ *  or POOL_HANDLES: create/destroy find the block by the binary search, O(log blocks))
  *
  *  Notes:
  *
@@ -1528,7 +5918,9 @@ POOL_USING_ALIAS(Pool_dlist_block , Pool_dlist_block )
  *  If flag POOL_FIXED_CAPACITY is set, new nodes are add
  *  only by the reserve() method.
  *
- *  shrink_to_fit for Pool_xxx_block work only for empty pool.
+ *  shrink_to_fit for Pool_xxx_block works only for empty pool, with the flag
+ *  POOL_TRIM_BLOCKS or POOL_FULLEST_BLOCK it releases the empty blocks while
+ *  the pool isn't empty.
  *
  *  Pool_xxx_block is an analogue of Pool_xxx, the difference is that we
  *  allocate memory in blocks of N nodes at a time. If N == 1, this does
@@ -1539,23 +5931,33 @@ POOL_USING_ALIAS(Pool_dlist_block , Pool_dlist_block )
  *  Therefore, the user must ensure that all objects was be destroyed when
  *  the destructor is called. Otherwise, it can lead to a memory leak.
  *
+ *  Pools P_lmt, P_lbm are thread-safe analogues of P_l, P_lb (with the same
+ *  complexity): methods create/destroy can be called concurrently.
+ *  Methods reserve, shrink_to_fit, move and destructor are not thread-safe.
+ *
+ *  Pool SP_sh is a thread-safe analogue of SP_l for the shared memory (without
+ *  for_each and destroy_all), it has no pointers (see SPool_shared).
+ *
  *  For more details see concrete implementation
  */
 template <typename     T,
           std::size_t  N,
           std::size_t  Align = alignof(T),
           Pool_flags_t Flags = 0,
-          template<typename, std::size_t, std::size_t, Pool_flags_t> class Impl = Pool_dlist>
-class Pool: public Impl<T, N, Align, Flags>
+          template<typename, std::size_t, std::size_t, Pool_flags_t, typename...> class Impl = Pool_dlist,
+          typename...  Source>
+class Pool: public Impl<T, N, Align, Flags, Source...>
 {
+    using Base = Impl<T, N, Align, Flags, Source...>;
+
     public:
-        using Impl<T, N, Align, Flags>::Impl; //for using explicit ctors!
+        using Base::Base; //for using explicit ctors!
 
         template <typename... Args>
         T* create(Args&&... args) noexcept(pool_impl::is_nothrow_create<T, Args...> &&
                                            !(Flags & POOL_CREATE_EXCEPTION))
         {
-            auto obj = Impl<T, N, Align, Flags>::create(std::forward<Args>(args)...);
+            auto obj = Base::create(std::forward<Args>(args)...);
 
             if constexpr(Flags & POOL_CREATE_EXCEPTION)
             {
@@ -1565,9 +5967,299 @@ class Pool: public Impl<T, N, Align, Flags>
 
             return obj;
         }
+
+
+        template <typename... Args>
+        std::size_t create_n(T** objs, std::size_t n, const Args&... args)
+            noexcept(pool_impl::is_nothrow_create<T, const Args&...> &&
+                     !(Flags & POOL_CREATE_EXCEPTION))
+        {
+            auto cnt = Base::create_n(objs, n, args...);
+
+            if constexpr(Flags & POOL_CREATE_EXCEPTION)
+            {
+                if(cnt != n)
+                {
+                    this->destroy_n(objs, cnt); //strong exception guarantee
+                    throw std::bad_alloc();
+                }
+            }
+
+            return cnt;
+        }
+
+
+        //POOL_HANDLES, POOL_HANDLES_64 (SPool_xxx, Pool_xxx_block)
+        template <typename... Args>
+        auto create_handle(Args&&... args) noexcept(pool_impl::is_nothrow_create<T, Args...> &&
+                                                    !(Flags & POOL_CREATE_EXCEPTION))
+        {
+            return this->handle_of(create(std::forward<Args>(args)...));
+        }
+
+
+        using Base::destroy;
+
+        template <typename U>
+        void destroy(pool_impl::Pool_handle<U> handle) noexcept
+        {
+            Base::destroy(this->get(handle));
+        }
+};
+
+
+
+
+
+
+
+
+/*
+ *  Per-thread cache (magazine) in front of a dynamic pool
+ *
+ *  Template parameters:
+ *  T, N, Align, Flags - see Pool
+ *  Impl    - Dynamic implementation (algorithm) of the shared pool
+ *  MagSize - The count of free nodes cached in each Magazine
+ *
+ *  Usage:
+ *  Pool_magazine<Msg, 1024> pool;                      //shared
+ *  thread_local Pool_magazine<Msg, 1024>::Magazine mag(pool); //per-thread
+ *  auto msg = mag.create(...);
+ *  mag.destroy(msg);
+ */
+template <typename     T,
+          std::size_t  N,
+          std::size_t  Align   = alignof(T),
+          Pool_flags_t Flags   = 0,
+          template<typename, std::size_t, std::size_t, Pool_flags_t, typename...> class Impl = Pool_list_block,
+          std::size_t  MagSize = 32>
+using Pool_magazine = pool_impl::Pool_magazine<T, N, Align, Flags, Impl, MagSize>;
+
+
+
+
+
+/*
+ *  Size-class multi-pool (slab allocator): the general-purpose heap of small objects
+ *
+ *  Template parameters:
+ *  N     - see Pool (the block size for Pool_xxx_block)
+ *  Flags - see Pool
+ *  Impl  - Dynamic implementation (algorithm) of the pools of size classes
+ *  Sizes - The sizes of classes in ascending order (multiples of 8),
+ *          by default: 16, 32, 64, 128, 256, 512
+ *
+ *  Usage:
+ *  Pool_size_classes<> heap;
+ *  void* p = heap.allocate(sizeof(Msg), alignof(Msg));
+ *  heap.deallocate(p, sizeof(Msg), alignof(Msg));
+ *
+ *  Msg* msg = heap.create<Msg>(...);
+ *  heap.destroy(msg);
+ */
+template <std::size_t  N     = 64,
+          Pool_flags_t Flags = 0,
+          template<typename, std::size_t, std::size_t, Pool_flags_t, typename...> class Impl = Pool_list_block,
+          std::size_t... Sizes>
+using Pool_size_classes = pool_impl::Pool_size_classes<N, Flags, Impl,
+                              std::conditional_t<sizeof...(Sizes) == 0,
+                                                 std::index_sequence<16, 32, 64, 128, 256, 512>,
+                                                 std::index_sequence<Sizes...>>>;
+
+
+
+
+#if defined(POOL_MEMORY_RESOURCE)
+/*
+ *  std::pmr::memory_resource on top of a dynamic pool
+ *
+ *  Template parameters:
+ *  Size  - The size of the nodes (the max size of the pool requests)
+ *  Align - The alignment of the nodes (the max alignment of the pool requests)
+ *  N     - see Pool (the block size for Pool_xxx_block)
+ *  Flags - see Pool
+ *  Impl  - Dynamic implementation (algorithm) of the pool
+ *
+ *  Technical details:
+ *
+ *  The requests with bytes <= Size and alignment <= Align are allocated
+ *  from the pool (complexity O(1)), other requests go to the upstream resource.
+ *  So it's for the node-based containers (std::pmr::list, std::pmr::map,
+ *  std::pmr::unordered_map nodes), the sizes of their nodes are fixed.
+ *  The resource is not thread-safe (as std::pmr::unsynchronized_pool_resource).
+ *
+ *  Usage:
+ *  pool_memory_resource<64> mr;
+ *  std::pmr::list<int>      list(&mr);
+ */
+template <std::size_t  Size,
+          std::size_t  Align = alignof(std::max_align_t),
+          std::size_t  N     = 64,
+          Pool_flags_t Flags = 0,
+          template<typename, std::size_t, std::size_t, Pool_flags_t, typename...> class Impl = Pool_list_block>
+class pool_memory_resource: public std::pmr::memory_resource
+{
+    public:
+        using pool_type = Pool<pool_impl::Raw_storage<Size, Align>, N, Align, Flags, Impl>;
+
+        static constexpr std::size_t SIZE  = Size;
+        static constexpr std::size_t ALIGN = Align;
+
+        pool_memory_resource() noexcept:
+            pool_memory_resource(std::pmr::get_default_resource())
+        {}
+
+        explicit pool_memory_resource(std::pmr::memory_resource* upstream) noexcept:
+            m_upstream(upstream)
+        {}
+
+        pool_memory_resource(const pool_memory_resource&)            = delete;
+        pool_memory_resource& operator=(const pool_memory_resource&) = delete;
+
+        std::pmr::memory_resource* upstream_resource() const noexcept { return m_upstream; }
+
+        pool_type&       pool()       noexcept { return m_pool; }
+        const pool_type& pool() const noexcept { return m_pool; }
+
+
+    protected:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override
+        {
+            if(!from_pool(bytes, alignment))
+                return m_upstream->allocate(bytes, alignment);
+
+            void* p = m_pool.create();
+
+            if(!p)
+                throw std::bad_alloc(); //POOL_FIXED_CAPACITY and the pool is full
+
+            return p;
+        }
+
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+        {
+            if(from_pool(bytes, alignment))
+                m_pool.destroy(static_cast<typename pool_type::value_type*>(p));
+            else
+                m_upstream->deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+        {
+            return this == &other;
+        }
+
+
+    private:
+        pool_type                  m_pool;
+        std::pmr::memory_resource *m_upstream;
+
+        static constexpr bool from_pool(std::size_t bytes, std::size_t alignment) noexcept
+        {
+            return bytes <= Size && alignment <= Align;
+        }
+};
+#endif // POOL_MEMORY_RESOURCE
+
+
+
+
+
+/*
+ *  Allocator (see named requirements Allocator) on top of a dynamic pool
+ *
+ *  Template parameters:
+ *  T    - The type of the elements.
+ *  N    - see Pool (the block size for Pool_xxx_block)
+ *  Impl - Dynamic implementation (algorithm) of the pool
+ *
+ *  Technical details:
+ *
+ *  All allocators of the same (rebound) type share one pool: the containers
+ *  rebind the allocator to the type of their nodes, so each node type gets its
+ *  own pool of the nodes of its size. The allocations of one object
+ *  (the nodes of std::list, std::map, std::unordered_map) are taken from
+ *  the pool, the allocations of arrays (the buckets of std::unordered_map)
+ *  go to std::allocator.
+ *  The pool is never destroyed (it lives until exit), so the containers with
+ *  static storage duration are safe in their destructors.
+ *  The pool is shared by all threads, so for the multithreading use
+ *  the thread-safe Impl (Pool_list_mt, Pool_list_block_mt).
+ *
+ *  Usage:
+ *  std::unordered_map<int, Msg, std::hash<int>, std::equal_to<int>,
+ *                     pool::allocator<std::pair<const int, Msg>>> map;
+ */
+template <typename    T,
+          std::size_t N = 64,
+          template<typename, std::size_t, std::size_t, Pool_flags_t, typename...> class Impl = Pool_list_block>
+class allocator
+{
+    public:
+        using value_type = T;
+        using pool_type  = Pool<pool_impl::Raw_storage<sizeof(T), alignof(T)>, N, alignof(T), 0, Impl>;
+
+        using propagate_on_container_move_assignment = std::true_type;
+        using is_always_equal                        = std::true_type;
+
+        template <class U>
+        struct rebind { using other = allocator<U, N, Impl>; };
+
+        allocator() noexcept = default;
+
+        template <class U>
+        allocator(const allocator<U, N, Impl>&) noexcept {}
+
+
+        T* allocate(std::size_t n)
+        {
+            if(n != 1)
+                return std::allocator<T>().allocate(n);
+
+            auto p = pool().create();
+
+            if(!p)
+                throw std::bad_alloc();
+
+            return reinterpret_cast<T*>(p);
+        }
+
+
+        void deallocate(T* p, std::size_t n) noexcept
+        {
+            if(n != 1)
+                std::allocator<T>().deallocate(p, n);
+            else
+                pool().destroy(reinterpret_cast<typename pool_type::value_type*>(p));
+        }
+
+
+        //The shared pool of this (rebound) type
+        static pool_type& pool()
+        {
+            static pool_type* pool = new pool_type; //is never destroyed (see above)
+            return *pool;
+        }
 };
 
 
+template <class T, class U, std::size_t N,
+          template<typename, std::size_t, std::size_t, Pool_flags_t, typename...> class Impl>
+constexpr bool operator==(const allocator<T, N, Impl>&, const allocator<U, N, Impl>&) noexcept
+{
+    return true;
+}
+
+
+template <class T, class U, std::size_t N,
+          template<typename, std::size_t, std::size_t, Pool_flags_t, typename...> class Impl>
+constexpr bool operator!=(const allocator<T, N, Impl>&, const allocator<U, N, Impl>&) noexcept
+{
+    return false;
+}
+
+
 
 } // namespace pool
 
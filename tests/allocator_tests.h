@@ -0,0 +1,137 @@
+#ifndef ALLOCATOR_TESTS_H
+#define ALLOCATOR_TESTS_H
+
+#include <list>
+#include <map>
+#include <memory>
+#include <unordered_map>
+
+#include "stest.h"
+#include "helpers.h"
+#include "pool.h"
+
+
+
+
+using namespace pool;
+
+
+
+
+template <typename T>
+using Test_allocator = pool::allocator<T, 16, IMPL>;
+
+
+struct Big_struct
+{
+    alignas(32) char data[100];
+};
+
+
+
+TEST(alloc_test_traits)
+{
+    using A      = Test_allocator<int>;
+    using Traits = std::allocator_traits<A>;
+
+    TEST_STATIC_ASSERT((std::is_same_v<Traits::value_type, int>));
+    TEST_STATIC_ASSERT((std::is_same_v<Traits::rebind_alloc<Big_struct>, Test_allocator<Big_struct>>));
+    TEST_STATIC_ASSERT(Traits::is_always_equal::value);
+
+    A                          a;
+    Test_allocator<Big_struct> b(a); //rebind
+
+    TEST_ASSERT(a == b);
+    TEST_ASSERT(!(a != b));
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(alloc_test_allocate)
+{
+    Test_allocator<Big_struct> a;
+    auto &pool = Test_allocator<Big_struct>::pool();
+
+    std::array<Big_struct*, 40> ptrs;
+
+    for(auto &p: ptrs)
+    {
+        p = std::allocator_traits<decltype(a)>::allocate(a, 1);
+        TEST_ASSERT(p != nullptr);
+        TEST_ASSERT((std::uintptr_t)(p)%32 == 0);
+    }
+
+    TEST_ASSERT(pool.size() == ptrs.size());
+
+    auto arr = a.allocate(3); //arrays go to std::allocator
+    TEST_ASSERT(pool.size() == ptrs.size());
+    a.deallocate(arr, 3);
+
+    for(auto p: ptrs)
+        a.deallocate(p, 1);
+
+    TEST_ASSERT(pool.size() == 0);
+
+    //all allocators of the same type share one pool
+    TEST_ASSERT(&Test_allocator<Big_struct>::pool() == &pool);
+    TEST_ASSERT((void*)&Test_allocator<char>::pool() != (void*)&pool);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(alloc_test_containers)
+{
+    std::list<int, Test_allocator<int>> list;
+    std::map<int, int, std::less<int>, Test_allocator<std::pair<const int, int>>> map;
+    std::unordered_map<int, int, std::hash<int>, std::equal_to<int>,
+                       Test_allocator<std::pair<const int, int>>> umap;
+
+    for(int i = 0; i < 1000; i++)
+    {
+        list.push_back(i);
+        map[i]  = i;
+        umap[i] = i;
+    }
+
+    for(int i = 0; i < 1000; i += 2)
+    {
+        map.erase(i);
+        umap.erase(i);
+    }
+
+    TEST_ASSERT(list.size() == 1000);
+    TEST_ASSERT(map.size()  == 500);
+    TEST_ASSERT(umap.size() == 500);
+
+    for(int i = 1; i < 1000; i += 2)
+    {
+        TEST_ASSERT(map.at(i)  == i);
+        TEST_ASSERT(umap.at(i) == i);
+    }
+
+    auto list2 = std::move(list);
+    TEST_ASSERT(list2.size() == 1000);
+    TEST_ASSERT(list2.back() == 999);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+
+static stest_func alloc_tests[] =
+{
+    alloc_test_traits,
+    alloc_test_allocate,
+    alloc_test_containers,
+};
+
+
+
+
+
+#endif // ALLOCATOR_TESTS_H
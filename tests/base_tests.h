@@ -57,6 +57,35 @@ TEST(test_pool_align)
 
 
 
+TEST(test_pool_cache_line)
+{
+    const size_t N = 8;
+    static Pool<int, N, alignof(int), POOL_CACHE_LINE, IMPL> pool;
+    std::array<int*, N> items;
+
+    for(size_t i = 0; i < N; i++)
+    {
+        items[i] = pool.create(int(i));
+        TEST_ASSERT(items[i] != nullptr);
+        TEST_ASSERT((std::uintptr_t)(items[i]) % POOL_CACHE_LINE_SIZE == 0);
+
+        //each object is on its own cache line
+        for(size_t j = 0; j < i; j++)
+            TEST_ASSERT((std::uintptr_t)(items[i]) / POOL_CACHE_LINE_SIZE !=
+                        (std::uintptr_t)(items[j]) / POOL_CACHE_LINE_SIZE);
+    }
+
+    for(size_t i = 0; i < N; i++)
+    {
+        TEST_ASSERT(*items[i] == int(i));
+        pool.destroy(items[i]);
+    }
+
+    TEST_PASS(nullptr);
+}
+
+
+
 TEST(test_pool_size)
 {
     //use flag POOL_FIXED_CAPACITY it's no effect for Static
@@ -290,13 +319,60 @@ TEST(test_pool_dtor_off_struct)
 
 
 
+TEST(test_pool_fill)
+{
+    //N isn't a multiple of 64: the freed nodes are on the word boundaries
+    const size_t N = 300;
+    DECLARE_POOL(pool, int, N, 16, POOL_FIXED_CAPACITY)
+
+    std::array<int*, N> items;
+
+    for(size_t i = 0; i < N; i++)
+    {
+        items[i] = pool.create((int)i);
+        TEST_ASSERT(items[i] != nullptr);
+    }
+
+    TEST_ASSERT(pool.full()     == true);
+    TEST_ASSERT(pool.create(-1) == nullptr);
+
+    for(size_t i: {0, 63, 64, 299})
+    {
+        TEST_ASSERT(*items[i] == (int)i);
+        pool.destroy(items[i]);
+    }
+
+    TEST_ASSERT(pool.size() == N - 4);
+
+    for(size_t i: {0, 63, 64, 299})
+    {
+        items[i] = pool.create((int)i);
+        TEST_ASSERT(items[i] != nullptr);
+    }
+
+    TEST_ASSERT(pool.full()     == true);
+    TEST_ASSERT(pool.create(-1) == nullptr);
+
+    for(auto item: items)
+        pool.destroy(item);
+
+    TEST_ASSERT(pool.empty() == true);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+
 static stest_func base_tests[] =
 {
     test_pool_align,
+    test_pool_cache_line,
     test_pool_size,
     test_pool_create,
     test_pool_destroy,
     test_pool_struct,
+    test_pool_fill,
     #ifdef RUN_DTOR_OFF_TESTS
     test_pool_dtor_off_struct,
     #endif
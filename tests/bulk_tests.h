@@ -0,0 +1,289 @@
+#ifndef BULK_TESTS_H
+#define BULK_TESTS_H
+
+#include <new> //bad_alloc
+
+#include "stest.h"
+#include "helpers.h"
+#include "pool.h"
+
+
+
+
+using namespace pool;
+
+
+
+
+struct Throw_struct
+{
+    Throw_struct(int val): tag(val)
+    {
+        if(++created == throw_on)
+            throw 1;
+        cnt++;
+    }
+    ~Throw_struct() { cnt--; }
+
+    static inline int cnt      = 0;
+    static inline int created  = 0;
+    static inline int throw_on = 0;
+    int tag;
+};
+
+
+
+TEST(bulk_test_create_n)
+{
+    const size_t N = 10;
+    DECLARE_POOL(pool, int, N, 16, POOL_FIXED_CAPACITY)
+    std::array<int*, N+2> pint{};
+
+
+    TEST_ASSERT(pool.create_n(pint.data(), 4, 7) == 4);
+    TEST_ASSERT(pool.size() == 4);
+
+    //only N-4 free nodes
+    TEST_ASSERT(pool.create_n(pint.data() + 4, N, 8) == N-4);
+    TEST_ASSERT(pool.size() == N);
+    TEST_ASSERT(pool.full());
+
+    TEST_ASSERT(pool.create_n(pint.data() + N, 2, 9) == 0);
+    TEST_ASSERT(pool.size() == N);
+
+    for(size_t i = 0; i < N; i++)
+    {
+        TEST_ASSERT(pint[i] != nullptr);
+        TEST_ASSERT(*pint[i] == (i < 4 ? 7 : 8));
+        TEST_ASSERT((std::uintptr_t)(pint[i])%16 == 0);
+
+        for(size_t j = 0; j < i; j++)
+            TEST_ASSERT(pint[i] != pint[j]);
+    }
+
+
+    pool.destroy_n(pint.data(), 3);
+    TEST_ASSERT(pool.size() == N-3);
+
+    //nullptr are skipped
+    auto obj = pint[3];
+    pint[3]  = nullptr;
+    pool.destroy_n(pint.data() + 3, N-3);
+    TEST_ASSERT(pool.size() == 1);
+
+    pool.destroy(obj);
+    TEST_ASSERT(pool.size() == 0);
+
+    //create after destroy_n
+    TEST_ASSERT(pool.create_n(pint.data(), N, 1) == N);
+    TEST_ASSERT(pool.size() == N);
+
+    pool.destroy_n(pint.data(), N);
+    TEST_ASSERT(pool.size() == 0);
+
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(bulk_test_create_n_struct)
+{
+    const size_t N = 16;
+    DECLARE_POOL(pool, Temp_struct, N, 16, POOL_FIXED_CAPACITY)
+    std::array<Temp_struct*, N> objs;
+
+    TEST_ASSERT(Temp_struct::cnt == 0);
+
+    TEST_ASSERT(pool.create_n(objs.data(), N, 5) == N);
+    TEST_ASSERT(Temp_struct::cnt == N);
+
+    for(auto obj: objs)
+        TEST_ASSERT(obj->tag == 5);
+
+    pool.destroy_n(objs.data(), N);
+    TEST_ASSERT(Temp_struct::cnt == 0);
+    TEST_ASSERT(pool.size()      == 0);
+
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(bulk_test_create_n_except)
+{
+    const size_t N = 8;
+    DECLARE_POOL(pool, Throw_struct, N, 16, POOL_FIXED_CAPACITY)
+    std::array<Throw_struct*, N> objs;
+
+    Throw_struct::cnt      = 0;
+    Throw_struct::created  = 0;
+    Throw_struct::throw_on = 3;
+
+    try
+    {
+        pool.create_n(objs.data(), 5, 1);
+        TEST_FAIL(nullptr);
+    }
+    catch(int)
+    {
+    }
+
+    //strong exception guarantee
+    TEST_ASSERT(Throw_struct::cnt == 0);
+    TEST_ASSERT(pool.size()       == 0);
+
+    Throw_struct::throw_on = 0;
+    TEST_ASSERT(pool.create_n(objs.data(), N, 2) == N);
+    TEST_ASSERT(Throw_struct::cnt == N);
+
+    pool.destroy_n(objs.data(), N);
+    TEST_ASSERT(Throw_struct::cnt == 0);
+    TEST_ASSERT(pool.size()       == 0);
+
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(bulk_test_create_n_bad_alloc)
+{
+    const size_t N = 4;
+    DECLARE_POOL(pool, int, N, 16, POOL_FIXED_CAPACITY | POOL_CREATE_EXCEPTION)
+    std::array<int*, N+1> pint;
+
+    try
+    {
+        pool.create_n(pint.data(), N+1, 1);
+        TEST_FAIL(nullptr);
+    }
+    catch(const std::bad_alloc&)
+    {
+    }
+
+    TEST_ASSERT(pool.size() == 0);
+    TEST_ASSERT(pool.create_n(pint.data(), N, 1) == N);
+
+    pool.destroy_n(pint.data(), N);
+    TEST_ASSERT(pool.size() == 0);
+
+
+    TEST_PASS(nullptr);
+}
+
+
+
+[[maybe_unused]]
+TEST(bulk_test_create_n_grow) //only for dynamic
+{
+    const size_t N  = 4;
+    const size_t N2 = N*5 + 1;
+    Pool<Temp_struct, N, 16, 0, IMPL> pool;
+    std::array<Temp_struct*, N2> objs;
+
+    TEST_ASSERT(Temp_struct::cnt == 0);
+
+    TEST_ASSERT(pool.create_n(objs.data(), 2, 1) == 2);
+    TEST_ASSERT(pool.create_n(objs.data() + 2, N2 - 2, 2) == N2 - 2);
+    TEST_ASSERT(pool.size()      == N2);
+    TEST_ASSERT(pool.capacity()  >= N2);
+    TEST_ASSERT(Temp_struct::cnt == N2);
+
+    for(size_t i = 0; i < N2; i++)
+    {
+        TEST_ASSERT(objs[i]->tag == (i < 2 ? 1 : 2));
+        TEST_ASSERT((std::uintptr_t)(objs[i])%16 == 0);
+    }
+
+    pool.destroy_n(objs.data(), N2);
+    TEST_ASSERT(Temp_struct::cnt == 0);
+    TEST_ASSERT(pool.size()      == 0);
+
+    //nodes are reused
+    auto cap = pool.capacity();
+    TEST_ASSERT(pool.create_n(objs.data(), N2, 3) == N2);
+    TEST_ASSERT(pool.capacity() == cap);
+    pool.destroy_n(objs.data(), N2);
+
+
+    TEST_PASS(nullptr);
+}
+
+
+[[maybe_unused]]
+TEST(bulk_test_create_n_grow_except) //only for dynamic
+{
+    const size_t N  = 4;
+    const size_t N2 = 10;
+    Pool<Throw_struct, N, 16, 0, IMPL> pool;
+    std::array<Throw_struct*, N2 * 2> objs;
+
+    Throw_struct::cnt      = 0;
+    Throw_struct::created  = 0;
+    Throw_struct::throw_on = 7; //in the second batch (block) of nodes
+
+    try
+    {
+        pool.create_n(objs.data(), N2, 1);
+        TEST_FAIL(nullptr);
+    }
+    catch(int)
+    {
+    }
+
+    //strong exception guarantee: the objects of the done batches are destroyed too
+    TEST_ASSERT(Throw_struct::cnt == 0);
+    TEST_ASSERT(pool.size()       == 0);
+
+    //the free nodes are taken first, then the new ones
+    auto cap = pool.capacity();
+    TEST_ASSERT(cap + N <= objs.size());
+
+    Throw_struct::created  = 0;
+    Throw_struct::throw_on = int(cap) + 1;
+
+    try
+    {
+        pool.create_n(objs.data(), cap + N, 2);
+        TEST_FAIL(nullptr);
+    }
+    catch(int)
+    {
+    }
+
+    TEST_ASSERT(Throw_struct::cnt == 0);
+    TEST_ASSERT(pool.size()       == 0);
+
+    Throw_struct::throw_on = 0;
+    TEST_ASSERT(pool.create_n(objs.data(), N2, 3) == N2);
+    TEST_ASSERT(Throw_struct::cnt == int(N2));
+
+    pool.destroy_n(objs.data(), N2);
+    TEST_ASSERT(Throw_struct::cnt == 0);
+
+
+    TEST_PASS(nullptr);
+}
+
+
+
+
+static stest_func bulk_tests[] =
+{
+    bulk_test_create_n,
+    bulk_test_create_n_struct,
+    bulk_test_create_n_except,
+    bulk_test_create_n_bad_alloc,
+    #ifdef NEED_RESERVE
+    bulk_test_create_n_grow,
+    bulk_test_create_n_grow_except,
+    #endif
+};
+
+
+
+
+
+#endif // BULK_TESTS_H
@@ -0,0 +1,176 @@
+#ifndef COMPACT_TESTS_H
+#define COMPACT_TESTS_H
+
+#include <vector>
+#include <utility>
+#include <iterator>
+
+#include "stest.h"
+#include "helpers.h"
+#include "pool.h"
+
+
+
+
+using namespace pool;
+
+
+
+
+//Temp_struct with the move constructor (the moved objects are counted too)
+struct Compact_struct
+{
+    Compact_struct(int val):tag(val)                     { Temp_struct::cnt++; }
+    Compact_struct(Compact_struct&& other) noexcept:
+        tag(other.tag)                                   { Temp_struct::cnt++; }
+    ~Compact_struct()                                    { Temp_struct::cnt--; }
+
+    int tag;
+};
+
+
+//The objects are spread over the blocks: only each 10th of them is alive
+template <Pool_flags_t Flags>
+static struct test_info_t compact_move(struct test_case_t *test_case)
+{
+    Pool<Compact_struct, 16, 16, Flags, IMPL> pool;
+    std::vector<Compact_struct*> objs;
+
+    for(int i = 0; i < 5000; i++)
+        objs.push_back(pool.create(i));
+
+    const auto peak = pool.capacity();
+
+    for(int i = 0; i < 5000; i++)
+    {
+        if(i % 10)
+            pool.destroy(objs[i]);
+    }
+
+    std::vector<int> tags;
+    for(auto &obj: pool)
+        tags.push_back(obj.tag);
+
+    std::vector<std::pair<Compact_struct*, Compact_struct*>> moves;
+
+    const auto cnt = pool.compact([&](Compact_struct* from, Compact_struct* to)
+    {
+        moves.push_back({from, to});
+    });
+
+    TEST_ASSERT(cnt == moves.size());
+    TEST_ASSERT(cnt >  0);
+    TEST_ASSERT(pool.size()      == 500);
+    TEST_ASSERT(pool.capacity()  <  peak);
+    TEST_ASSERT(pool.capacity()  >= pool.size());
+    TEST_ASSERT(Temp_struct::cnt == 500);
+
+    //the new addresses are reported, the objects keep their order
+    for(auto &move: moves)
+    {
+        TEST_ASSERT(objs[move.second->tag] == move.first);
+        objs[move.second->tag] = move.second;
+    }
+
+    std::size_t i = 0;
+    for(auto &obj: pool)
+    {
+        TEST_ASSERT(obj.tag == tags[i]);
+        TEST_ASSERT(&obj    == objs[obj.tag]);
+        i++;
+    }
+    TEST_ASSERT(i == tags.size());
+
+    //the pool is still usable
+    for(int j = 0; j < 1000; j++)
+        TEST_ASSERT(pool.create(j) != nullptr);
+
+    pool.destroy_all();
+    TEST_ASSERT(Temp_struct::cnt == 0);
+
+    TEST_ASSERT(pool.compact() == 0);
+    TEST_ASSERT(pool.capacity() == 0);
+    TEST_ASSERT(pool.create(1) != nullptr);
+    pool.destroy_all();
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(compact_test_trim)
+{
+    return compact_move<POOL_TRIM_BLOCKS>(test_case);
+}
+
+
+
+TEST(compact_test_fullest)
+{
+    return compact_move<POOL_FULLEST_BLOCK>(test_case);
+}
+
+
+
+TEST(compact_test_grow)
+{
+    return compact_move<POOL_TRIM_BLOCKS | POOL_GROW_BLOCKS>(test_case);
+}
+
+
+
+TEST(compact_test_handles)
+{
+    Pool<Compact_struct, 16, 16, POOL_FULLEST_BLOCK | POOL_HANDLES, IMPL> pool;
+    std::vector<Compact_struct*> objs;
+
+    for(int i = 0; i < 2000; i++)
+        objs.push_back(pool.create(i));
+
+    for(int i = 0; i < 2000; i++)
+    {
+        if(i % 7)
+            pool.destroy(objs[i]);
+    }
+
+    auto h = pool.handle_of(objs[1400]);
+    Compact_struct* moved = objs[1400];
+
+    pool.compact([&](Compact_struct* from, Compact_struct* to)
+    {
+        if(from == moved)
+            moved = to;
+    });
+
+    //the object is found by its new handle, the old handle is stale
+    auto h2 = pool.handle_of(moved);
+    TEST_ASSERT(pool.get(h2)      == moved);
+    TEST_ASSERT(pool.get(h2)->tag == 1400);
+
+    if(moved != objs[1400])
+        TEST_ASSERT(pool.get(h) != moved);
+
+    TEST_ASSERT(std::distance(pool.begin(), pool.end()) == std::ptrdiff_t(pool.size()));
+
+    pool.destroy_all();
+    TEST_ASSERT(Temp_struct::cnt == 0);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+
+static stest_func compact_tests[] =
+{
+    compact_test_trim,
+    compact_test_fullest,
+    compact_test_grow,
+    compact_test_handles,
+};
+
+
+
+
+
+#endif // COMPACT_TESTS_H
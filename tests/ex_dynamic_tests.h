@@ -1,7 +1,9 @@
 #ifndef EX_DYNAMIC_TESTS_H
 #define EX_DYNAMIC_TESTS_H
 
+#include <algorithm>
 #include <utility> //swap
+#include <vector>
 
 #include "stest.h"
 #include "helpers.h"
@@ -649,6 +651,151 @@ TEST(ex_test_pool_swap)
 
 
 
+TEST(ex_test_pool_mmap_blocks)
+{
+    //the flag is used only by Pool_xxx_block, the others ignore it
+    using Big = std::array<char, 64>;
+
+    std::vector<void*> ptrs;
+
+    {
+        Pool<Temp_struct, 100, 32, POOL_MMAP_BLOCKS, IMPL> pool;
+
+        for(int i = 0; i < 1000; i++)
+        {
+            auto obj = pool.create(i);
+            TEST_ASSERT(obj != nullptr);
+            TEST_ASSERT(obj->tag == i);
+            TEST_ASSERT((std::uintptr_t)(obj)%32 == 0);
+            ptrs.push_back(obj);
+        }
+
+        TEST_ASSERT(Temp_struct::cnt == 1000);
+
+        for(auto p: ptrs)
+            pool.destroy((Temp_struct*)p);
+
+        pool.shrink_to_fit();
+        TEST_ASSERT(pool.capacity() == 0);
+    }
+
+    TEST_ASSERT(Temp_struct::cnt == 0);
+
+
+    //block >= 2 MiB: huge pages (MAP_HUGETLB or THP) if the system allows it
+    Pool<Big, 32768, alignof(Big), POOL_MMAP_BLOCKS, IMPL> pool;
+    pool.reserve(32768 + 1);
+    TEST_ASSERT(pool.capacity() >= 32768 + 1);
+
+    ptrs.clear();
+
+    for(int i = 0; i < 40000; i++)
+    {
+        auto obj = pool.create();
+        TEST_ASSERT(obj != nullptr);
+        (*obj)[0] = (char)i;
+        ptrs.push_back(obj);
+    }
+
+    for(auto p: ptrs)
+        pool.destroy((Big*)p);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+
+//Returns the growths of capacity while objects are created one by one
+template <class P>
+static std::vector<size_t> grow_steps(P &pool, std::vector<Temp_struct*> &objs, int n)
+{
+    std::vector<size_t> steps;
+
+    for(int i = 0; i < n; i++)
+    {
+        auto old = pool.capacity();
+        auto obj = pool.create(i);
+
+        if(!obj)
+            break;
+
+        objs.push_back(obj);
+
+        if(pool.capacity() != old)
+            steps.push_back(pool.capacity() - old);
+    }
+
+    return steps;
+}
+
+
+
+TEST(ex_test_pool_grow_blocks)
+{
+    //the flag is used only by Pool_xxx_block (capacity grows by the whole block)
+    const size_t N = 4;
+    std::vector<Temp_struct*> objs;
+
+    {
+        Pool<Temp_struct, N, 16, pool_grow_blocks_nodes(8 * N), IMPL> pool;
+
+        auto steps = grow_steps(pool, objs, 200);
+
+        TEST_ASSERT(objs.size()     == 200);
+        TEST_ASSERT(pool.capacity() >= 200);
+
+        if(steps[0] == N) //blocks: N, 2N, 4N, 8N, 8N...
+        {
+            for(size_t i = 0; i < steps.size(); i++)
+                TEST_ASSERT(steps[i] == std::min(N << i, 8 * N));
+        }
+
+        for(size_t i = 0; i < objs.size(); i++)
+            TEST_ASSERT(objs[i]->tag == (int)i);
+
+        for(auto obj: objs)
+            pool.destroy(obj);
+
+        pool.shrink_to_fit();
+        TEST_ASSERT(pool.capacity() == 0);
+
+
+        //create_n hands out the whole blocks of different sizes
+        std::array<Temp_struct*, 100> arr;
+        TEST_ASSERT(pool.create_n(arr.data(), arr.size(), 7) == arr.size());
+        TEST_ASSERT(Temp_struct::cnt == (int)arr.size());
+
+        for(auto obj: arr)
+            TEST_ASSERT(obj->tag == 7 && (uintptr_t)obj % 16 == 0);
+
+        pool.destroy_n(arr.data(), arr.size());
+        pool.shrink_to_fit();
+        TEST_ASSERT(pool.capacity() == 0);
+    }
+
+    TEST_ASSERT(Temp_struct::cnt == 0);
+    objs.clear();
+
+
+    //the limit in bytes of block (with header)
+    Pool<Temp_struct, N, 16, pool_grow_blocks_bytes(1024), IMPL> pool;
+
+    auto steps = grow_steps(pool, objs, 500);
+    TEST_ASSERT(objs.size() == 500);
+
+    auto max_step = *std::max_element(steps.begin(), steps.end());
+    TEST_ASSERT(max_step * 16 <= 1024);
+    TEST_ASSERT(steps[0] != N || max_step > N);
+
+    for(auto obj: objs)
+        pool.destroy(obj);
+
+    TEST_PASS(nullptr);
+}
+
+
+
 static stest_func ex_dynamic_tests[] =
 {
     ex_test_pool_size,
@@ -660,6 +807,8 @@ static stest_func ex_dynamic_tests[] =
     ex_test_pool_shrink_to_fit2,
     ex_test_pool_move,
     ex_test_pool_swap,
+    ex_test_pool_mmap_blocks,
+    ex_test_pool_grow_blocks,
 };
 
 
@@ -0,0 +1,185 @@
+#ifndef HANDLE_TESTS_H
+#define HANDLE_TESTS_H
+
+#include <array>
+
+#include "stest.h"
+#include "helpers.h"
+#include "pool.h"
+
+
+
+
+using namespace pool;
+
+
+
+
+TEST(handle_test_create_get)
+{
+    TEST_ASSERT(Temp_struct::cnt == 0);
+
+    {
+        DECLARE_POOL(pool, Temp_struct, 64, 16, POOL_HANDLES);
+
+        using Handle = decltype(pool.create_handle(0));
+        TEST_ASSERT(sizeof(Handle) == 4);
+
+        std::array<Handle, 64> handles;
+
+        for(int i = 0; i < 64; i++)
+        {
+            handles[i] = pool.create_handle(i);
+            TEST_ASSERT(handles[i]);
+        }
+
+        TEST_ASSERT(pool.size()      == 64);
+        TEST_ASSERT(Temp_struct::cnt == 64);
+
+        for(int i = 0; i < 64; i++)
+        {
+            auto obj = pool.get(handles[i]);
+            TEST_ASSERT(obj != nullptr);
+            TEST_ASSERT(obj->tag == i);
+            TEST_ASSERT(pool.handle_of(obj) == handles[i]);
+        }
+
+        //the slot of destroyed object is reused, but the old handle is stale
+        auto old = handles[10];
+        pool.destroy(old);
+        TEST_ASSERT(pool.get(old)    == nullptr);
+        TEST_ASSERT(Temp_struct::cnt == 63);
+
+        handles[10] = pool.create_handle(100);
+        TEST_ASSERT(handles[10]         != old);
+        TEST_ASSERT(pool.get(old)       == nullptr);
+        TEST_ASSERT(pool.get(handles[10])->tag == 100);
+
+        //the stale handle doesn't destroy the new object
+        pool.destroy(old);
+        TEST_ASSERT(Temp_struct::cnt == 64);
+
+        for(auto handle: handles)
+            pool.destroy(handle);
+
+        for(auto handle: handles)
+            TEST_ASSERT(pool.get(handle) == nullptr);
+
+        TEST_ASSERT(pool.size() == 0);
+    }
+
+    TEST_ASSERT(Temp_struct::cnt == 0);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(handle_test_raw_api)
+{
+    DECLARE_POOL(pool, Temp_struct, 64, 16, POOL_HANDLES_64);
+
+    using Handle = decltype(pool.create_handle(0));
+    TEST_ASSERT(sizeof(Handle) == 8);
+
+    //the null and invalid handles
+    TEST_ASSERT(!Handle{});
+    TEST_ASSERT(pool.get(Handle{})    == nullptr);
+    TEST_ASSERT(pool.get(Handle{~0u}) == nullptr);
+    TEST_ASSERT(pool.handle_of(nullptr) == Handle{});
+
+    //the objects of create/destroy(T*) have the handles too
+    auto obj    = pool.create(1);
+    auto handle = pool.handle_of(obj);
+    TEST_ASSERT(pool.get(handle) == obj);
+
+    //the slot which was never used (the generations of static pool are set lazily)
+    using Value = decltype(handle.value);
+    TEST_ASSERT(pool.get(Handle{Value(handle.value ^ 63)}) == nullptr);
+
+    pool.destroy(obj);
+    TEST_ASSERT(pool.get(handle) == nullptr);
+
+    std::array<Temp_struct*, 32> objs;
+    std::array<Handle, 32>       handles;
+
+    TEST_ASSERT(pool.create_n(objs.data(), objs.size(), 7) == objs.size());
+
+    for(std::size_t i = 0; i < objs.size(); i++)
+    {
+        handles[i] = pool.handle_of(objs[i]);
+        TEST_ASSERT(pool.get(handles[i]) == objs[i]);
+    }
+
+    pool.destroy_n(objs.data(), objs.size());
+
+    for(auto h: handles)
+        TEST_ASSERT(pool.get(h) == nullptr);
+
+    TEST_ASSERT(Temp_struct::cnt == 0);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+#ifdef NEED_RESERVE
+TEST(handle_test_blocks)
+{
+    Pool<Temp_struct, 16, 16, POOL_HANDLES | POOL_TRIM_BLOCKS, IMPL> pool;
+
+    std::array<Temp_struct*, 200> objs;
+    TEST_ASSERT(pool.create_n(objs.data(), objs.size(), 3) == objs.size());
+
+    const auto h0 = pool.handle_of(objs[0]);
+    const auto h1 = pool.handle_of(objs[199]);
+    TEST_ASSERT(pool.get(h0) == objs[0]);
+    TEST_ASSERT(pool.get(h1) == objs[199]);
+
+    //the blocks are released and allocated again (with the same ids)
+    pool.destroy_n(objs.data(), objs.size());
+    pool.shrink_to_fit();
+    TEST_ASSERT(pool.capacity() == 0);
+    TEST_ASSERT(pool.get(h0)    == nullptr);
+    TEST_ASSERT(pool.get(h1)    == nullptr);
+
+    TEST_ASSERT(pool.create_n(objs.data(), objs.size(), 4) == objs.size());
+    TEST_ASSERT(pool.get(h0) == nullptr);
+    TEST_ASSERT(pool.get(h1) == nullptr);
+
+    for(auto obj: objs)
+    {
+        auto handle = pool.handle_of(obj);
+        TEST_ASSERT(pool.get(handle) == obj);
+        pool.destroy(handle);
+    }
+
+    //the pool with handles can be moved
+    auto handle = pool.create_handle(5);
+    auto pool2  = std::move(pool);
+    TEST_ASSERT(pool2.get(handle)->tag == 5);
+    pool2.destroy(handle);
+
+    TEST_ASSERT(Temp_struct::cnt == 0);
+
+    TEST_PASS(nullptr);
+}
+#endif
+
+
+
+
+static stest_func handle_tests[] =
+{
+    handle_test_create_get,
+    handle_test_raw_api,
+#ifdef NEED_RESERVE
+    handle_test_blocks,
+#endif
+};
+
+
+
+
+
+#endif // HANDLE_TESTS_H
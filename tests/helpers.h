@@ -1,6 +1,8 @@
 #ifndef HELPERS_H
 #define HELPERS_H
 
+#include <atomic>
+
 #include "stest.h"
 
 
@@ -25,7 +27,7 @@ struct Temp_struct
         cnt--;
 //        std::cout << "destr " << tag << "\n";
     }
-    static inline int cnt = 0;
+    static inline std::atomic<int> cnt{0}; //the objects are created in the mt tests too
     int tag;
 };
 
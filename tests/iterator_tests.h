@@ -4,6 +4,7 @@
 #include "stest.h"
 #include "helpers.h"
 #include "pool.h"
+#include <vector>
 #include <algorithm>
 
 
@@ -581,6 +582,50 @@ TEST(iter_test_remove)
 
 
 
+TEST(iter_test_sparse)
+{
+    //N is not a multiple of 64, the used objects cross the words of the bitset
+    const size_t N = 300;
+    std::array<size_t, 7> used = {0, 1, 63, 64, 130, 257, 299};
+    std::array<size_t*, N> objs;
+
+    DECLARE_POOL(pool, size_t, N, alignof(size_t), POOL_FIXED_CAPACITY)
+
+    for(size_t i = 0; i < N; i++)
+        objs[i] = pool.create(i);
+
+    for(size_t i = 0, j = 0; i < N; i++)
+    {
+        if(j < used.size() && used[j] == i)
+            j++;
+        else
+            pool.destroy(objs[i]);
+    }
+
+    TEST_ASSERT(pool.size() == used.size());
+
+
+    std::vector<size_t> forward(pool.begin(), pool.end());
+    TEST_ASSERT(forward.size() == used.size());
+    TEST_ASSERT(std::is_permutation(forward.begin(), forward.end(), used.begin()));
+
+    std::vector<size_t> backward(pool.rbegin(), pool.rend());
+    std::reverse(backward.begin(), backward.end());
+    TEST_ASSERT(forward == backward);
+
+    size_t cnt = 0;
+    pool.for_each([&cnt](size_t *){ cnt++; });
+    TEST_ASSERT(cnt == used.size());
+
+    pool.destroy_all();
+    TEST_ASSERT(pool.begin() == pool.end());
+
+
+    TEST_PASS(nullptr);
+}
+
+
+
 static stest_func iter_tests[] =
 {
     iter_test_for_range,
@@ -595,6 +640,7 @@ static stest_func iter_tests[] =
     iter_test_reverse2,
     iter_test_destroy,
     iter_test_remove,
+    iter_test_sparse,
 };
 
 
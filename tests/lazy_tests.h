@@ -0,0 +1,129 @@
+#ifndef LAZY_TESTS_H
+#define LAZY_TESTS_H
+
+#include <cstring>
+#include <vector>
+#include <algorithm>
+
+#include "stest.h"
+#include "helpers.h"
+#include "pool.h"
+
+
+
+
+using namespace pool;
+
+
+
+
+//The ctor doesn't write the links of nodes: the bytes of nodes are intact
+TEST(lazy_test_ctor)
+{
+    using Pool_type = Pool<int, 1000, alignof(int), 0, IMPL>;
+
+    alignas(Pool_type) static std::byte buf[sizeof(Pool_type)];
+    std::memset(buf, 0xAB, sizeof(buf));
+
+    auto pool = ::new (buf) Pool_type;
+
+    std::size_t changed = 0;
+    for(auto byte: buf)
+        changed += (byte != std::byte(0xAB));
+
+    TEST_ASSERT(changed < 256); //the head of lists, the bitset of used nodes
+
+    auto obj = pool->create(1);
+    TEST_ASSERT(obj && *obj == 1);
+    pool->destroy(obj);
+
+    pool->~Pool_type();
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(lazy_test_order)
+{
+    const std::size_t N = 1000;
+    Pool<Temp_struct, N, alignof(Temp_struct), 0, IMPL> pool;
+
+    std::vector<Temp_struct*> objs;
+
+    //the untouched nodes are taken in the order of address
+    for(int i = 0; i < 10; i++)
+        objs.push_back(pool.create(i));
+
+    for(std::size_t i = 1; i < objs.size(); i++)
+        TEST_ASSERT(objs[i] - objs[i - 1] == objs[1] - objs[0] && objs[1] > objs[0]);
+
+    //the returned node is used first
+    pool.destroy(objs[3]);
+    auto obj = pool.create(3);
+    TEST_ASSERT(obj == objs[3]);
+
+    std::size_t cnt = 0;
+    pool.for_each([&cnt](Temp_struct*){ cnt++; });
+    TEST_ASSERT(cnt == 10);
+
+    while(pool.create(0))
+        ;
+
+    TEST_ASSERT(pool.full());
+    TEST_ASSERT(pool.size() == N);
+    TEST_ASSERT(Temp_struct::cnt == int(N));
+
+    pool.destroy_all();
+    TEST_ASSERT(Temp_struct::cnt == 0);
+    TEST_ASSERT(pool.empty());
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(lazy_test_create_n)
+{
+    const std::size_t N = 100;
+    Pool<Temp_struct, N, alignof(Temp_struct), 0, IMPL> pool;
+
+    //the free list has one returned node, the rest is untouched
+    pool.destroy(pool.create(1));
+
+    std::vector<Temp_struct*> objs(N + 1);
+    TEST_ASSERT(pool.create_n(objs.data(), 5, 5) == 5);
+    TEST_ASSERT(pool.size() == 5);
+
+    TEST_ASSERT(pool.create_n(objs.data() + 5, N, 6) == N - 5);
+    TEST_ASSERT(pool.full());
+
+    std::sort(objs.begin(), objs.begin() + N);
+    TEST_ASSERT(std::adjacent_find(objs.begin(), objs.begin() + N) == objs.begin() + N);
+
+    pool.destroy_n(objs.data(), N);
+    TEST_ASSERT(pool.empty());
+    TEST_ASSERT(Temp_struct::cnt == 0);
+
+    TEST_ASSERT(pool.create_n(objs.data(), N, 7) == N);
+    pool.destroy_all();
+    TEST_ASSERT(Temp_struct::cnt == 0);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+
+static stest_func lazy_tests[] =
+{
+    lazy_test_ctor,
+    lazy_test_order,
+    lazy_test_create_n,
+};
+
+
+
+
+
+#endif // LAZY_TESTS_H
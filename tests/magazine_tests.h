@@ -0,0 +1,183 @@
+#ifndef MAGAZINE_TESTS_H
+#define MAGAZINE_TESTS_H
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "stest.h"
+#include "helpers.h"
+#include "pool.h"
+
+
+
+
+using namespace pool;
+
+
+
+
+TEST(mag_test_create)
+{
+    const size_t N = 10;
+    Pool_magazine<int, N, 16, 0, IMPL, 8> pool;
+    std::array<int*, N*2> pint;
+
+    {
+        decltype(pool)::Magazine mag(pool);
+
+        for(size_t i = 0; i < pint.size(); i++)
+        {
+            pint[i] = mag.create(i);
+            TEST_ASSERT(pint[i]  != nullptr);
+            TEST_ASSERT(*pint[i] == (int)i);
+            TEST_ASSERT((std::uintptr_t)(pint[i])%16 == 0);
+        }
+
+        for(size_t i = 0; i < pint.size(); i++)
+            TEST_ASSERT(*pint[i] == (int)i);
+
+        //nodes are taken by batches of MagSize/2
+        TEST_ASSERT(pool.size()     == pint.size());
+        TEST_ASSERT(pool.capacity() >= pint.size());
+
+        for(auto obj: pint)
+            mag.destroy(obj);
+
+        mag.destroy(nullptr); //no effect
+
+        //magazine keeps at most MagSize nodes
+        TEST_ASSERT(mag.count()    <= 8);
+        TEST_ASSERT(pool.size()    == mag.count());
+    } //flush
+
+    TEST_ASSERT(pool.size() == 0);
+
+    pool.shrink_to_fit();
+    TEST_ASSERT(pool.capacity() == 0);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(mag_test_refill_flush)
+{
+    Pool_magazine<int, 4, 16, 0, IMPL, 8> pool;
+    decltype(pool)::Magazine mag(pool);
+
+    int* i = mag.create(1);
+    TEST_ASSERT(i);
+    TEST_ASSERT(*i          == 1);
+    TEST_ASSERT(mag.count() == 3); //refill by 4 nodes, one is used
+    TEST_ASSERT(pool.size() == 4);
+
+    mag.destroy(i);
+    TEST_ASSERT(mag.count() == 4);
+    TEST_ASSERT(pool.size() == 4);
+
+    mag.flush();
+    TEST_ASSERT(mag.count() == 0);
+    TEST_ASSERT(pool.size() == 0);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(mag_test_fixed_capacity)
+{
+    const size_t N = 4;
+    Pool_magazine<Temp_struct, N, 16, POOL_FIXED_CAPACITY, IMPL, 4> pool;
+    pool.reserve(N);
+
+    TEST_ASSERT(Temp_struct::cnt == 0);
+
+    {
+        decltype(pool)::Magazine mag(pool);
+        std::array<Temp_struct*, N> objs;
+
+        for(size_t i = 0; i < N; i++)
+        {
+            objs[i] = mag.create(i);
+            TEST_ASSERT(objs[i]);
+            TEST_ASSERT(objs[i]->tag == (int)i);
+        }
+
+        TEST_ASSERT(Temp_struct::cnt == N);
+        TEST_ASSERT(mag.create(123)  == nullptr);
+        TEST_ASSERT(pool.capacity()  == N);
+
+        for(auto obj: objs)
+            mag.destroy(obj);
+
+        TEST_ASSERT(Temp_struct::cnt == 0);
+    }
+
+    TEST_ASSERT(pool.size() == 0);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(mag_test_threads)
+{
+    const size_t THREADS = 8;
+    const size_t ITERS   = 20000;
+
+    Pool_magazine<size_t, 64, alignof(size_t), 0, IMPL, 16> pool;
+    std::vector<std::thread> threads;
+    std::atomic<size_t> errors{0};
+
+    for(size_t t = 0; t < THREADS; t++)
+    {
+        threads.emplace_back([&pool, &errors, t]()
+        {
+            decltype(pool)::Magazine mag(pool);
+            std::array<size_t*, 24> objs;
+
+            for(size_t i = 0; i < ITERS; i++)
+            {
+                size_t tag = t * ITERS + i;
+
+                for(auto &obj: objs)
+                    obj = mag.create(tag);
+
+                for(auto obj: objs)
+                {
+                    if(!obj || *obj != tag)
+                        errors++;
+                }
+
+                for(auto obj: objs)
+                    mag.destroy(obj);
+            }
+        });
+    }
+
+    for(auto &thread: threads)
+        thread.join();
+
+    TEST_ASSERT(errors      == 0);
+    TEST_ASSERT(pool.size() == 0);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+
+static stest_func magazine_tests[] =
+{
+    mag_test_create,
+    mag_test_refill_flush,
+    mag_test_fixed_capacity,
+    mag_test_threads,
+};
+
+
+
+
+
+#endif // MAGAZINE_TESTS_H
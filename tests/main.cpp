@@ -4,31 +4,116 @@
 
 extern struct test_case_t base_case_spool_list            ;
 extern struct test_case_t ex_case_spool_list              ;
+extern struct test_case_t bulk_case_spool_list            ;
+extern struct test_case_t handle_case_spool_list          ;
+extern struct test_case_t stats_case_spool_list           ;
+extern struct test_case_t lazy_case_spool_list            ;
 
 extern struct test_case_t base_case_spool_list_bitset     ;
 extern struct test_case_t ex_case_spool_list_bitset       ;
 extern struct test_case_t iter_case_spool_list_bitset     ;
+extern struct test_case_t bulk_case_spool_list_bitset     ;
+extern struct test_case_t handle_case_spool_list_bitset   ;
+extern struct test_case_t parallel_case_spool_list_bitset ;
+extern struct test_case_t lazy_case_spool_list_bitset     ;
+extern struct test_case_t stats_case_spool_list_bitset    ;
+
+extern struct test_case_t base_case_spool_bitmap          ;
+extern struct test_case_t ex_case_spool_bitmap            ;
+extern struct test_case_t iter_case_spool_bitmap          ;
+extern struct test_case_t bulk_case_spool_bitmap          ;
+extern struct test_case_t handle_case_spool_bitmap        ;
+extern struct test_case_t parallel_case_spool_bitmap      ;
+extern struct test_case_t snapshot_case_spool_bitmap      ;
 
 extern struct test_case_t base_case_spool_dlist           ;
 extern struct test_case_t ex_case_spool_dlist             ;
 extern struct test_case_t iter_case_spool_dlist           ;
+extern struct test_case_t bulk_case_spool_dlist           ;
+extern struct test_case_t handle_case_spool_dlist         ;
+extern struct test_case_t stats_case_spool_dlist          ;
+extern struct test_case_t parallel_case_spool_dlist       ;
+extern struct test_case_t snapshot_case_spool_dlist       ;
+extern struct test_case_t lazy_case_spool_dlist           ;
+extern struct test_case_t split_case_spool_dlist          ;
+
+extern struct test_case_t base_case_spool_idlist          ;
+extern struct test_case_t ex_case_spool_idlist            ;
+extern struct test_case_t iter_case_spool_idlist          ;
+extern struct test_case_t bulk_case_spool_idlist          ;
+extern struct test_case_t handle_case_spool_idlist        ;
+extern struct test_case_t relocate_case_spool_idlist      ;
+extern struct test_case_t split_case_spool_idlist         ;
+extern struct test_case_t parallel_case_spool_idlist      ;
+extern struct test_case_t snapshot_case_spool_idlist      ;
+extern struct test_case_t stats_case_spool_idlist         ;
+
+extern struct test_case_t base_case_spool_shared          ;
+extern struct test_case_t mt_case_spool_shared            ;
+extern struct test_case_t bulk_case_spool_shared          ;
+extern struct test_case_t shared_case_spool_shared        ;
 
 
 extern struct test_case_t base_case_pool_list             ;
 extern struct test_case_t ex_dinamic_case_pool_list       ;
+extern struct test_case_t bulk_case_pool_list             ;
+extern struct test_case_t src_case_pool_list              ;
+extern struct test_case_t stats_case_pool_list            ;
 
 extern struct test_case_t base_case_pool_list_block       ;
 extern struct test_case_t ex_dinamic_case_pool_list_block ;
+extern struct test_case_t bulk_case_pool_list_block       ;
+extern struct test_case_t src_case_pool_list_block        ;
+extern struct test_case_t trim_case_pool_list_block       ;
+extern struct test_case_t handle_case_pool_list_block     ;
+extern struct test_case_t stats_case_pool_list_block      ;
 
 extern struct test_case_t base_case_pool_dlist            ;
 extern struct test_case_t ex_case_pool_dlist              ;
 extern struct test_case_t ex_dinamic_case_pool_dlist      ;
 extern struct test_case_t iter_case_pool_dlist            ;
+extern struct test_case_t bulk_case_pool_dlist            ;
+extern struct test_case_t src_case_pool_dlist             ;
+extern struct test_case_t stats_case_pool_dlist           ;
+extern struct test_case_t parallel_case_pool_dlist        ;
 
 extern struct test_case_t base_case_pool_dlist_block      ;
 extern struct test_case_t ex_case_pool_dlist_block        ;
 extern struct test_case_t ex_dinamic_case_pool_dlist_block;
 extern struct test_case_t iter_case_pool_dlist_block      ;
+extern struct test_case_t bulk_case_pool_dlist_block      ;
+extern struct test_case_t src_case_pool_dlist_block       ;
+extern struct test_case_t trim_case_pool_dlist_block      ;
+extern struct test_case_t handle_case_pool_dlist_block    ;
+extern struct test_case_t stats_case_pool_dlist_block     ;
+extern struct test_case_t parallel_case_pool_dlist_block  ;
+extern struct test_case_t compact_case_pool_dlist_block   ;
+extern struct test_case_t snapshot_case_pool_dlist_block  ;
+extern struct test_case_t split_case_pool_dlist_block     ;
+
+extern struct test_case_t base_case_pool_list_mt            ;
+extern struct test_case_t ex_dinamic_case_pool_list_mt      ;
+extern struct test_case_t mt_case_pool_list_mt              ;
+extern struct test_case_t bulk_case_pool_list_mt            ;
+extern struct test_case_t src_case_pool_list_mt             ;
+
+extern struct test_case_t base_case_pool_list_block_mt      ;
+extern struct test_case_t ex_dinamic_case_pool_list_block_mt;
+extern struct test_case_t mt_case_pool_list_block_mt        ;
+extern struct test_case_t bulk_case_pool_list_block_mt      ;
+extern struct test_case_t src_case_pool_list_block_mt       ;
+
+extern struct test_case_t mag_case_pool_list_block          ;
+extern struct test_case_t mag_case_pool_dlist_block         ;
+
+extern struct test_case_t pmr_case_pool_list_block          ;
+extern struct test_case_t pmr_case_pool_dlist_block         ;
+
+extern struct test_case_t alloc_case_pool_list_block        ;
+extern struct test_case_t alloc_case_pool_list_block_mt     ;
+
+extern struct test_case_t sc_case_pool_list_block           ;
+extern struct test_case_t sc_case_pool_dlist_block          ;
 
 
 
@@ -36,31 +121,116 @@ static struct test_case_t *cases[] =
 {
     &base_case_spool_list            ,
     &ex_case_spool_list              ,
+    &bulk_case_spool_list            ,
+    &handle_case_spool_list          ,
+    &stats_case_spool_list           ,
+    &lazy_case_spool_list            ,
 
     &base_case_spool_list_bitset     ,
     &ex_case_spool_list_bitset       ,
     &iter_case_spool_list_bitset     ,
+    &bulk_case_spool_list_bitset     ,
+    &handle_case_spool_list_bitset   ,
+    &parallel_case_spool_list_bitset ,
+    &lazy_case_spool_list_bitset     ,
+    &stats_case_spool_list_bitset    ,
+
+    &base_case_spool_bitmap          ,
+    &ex_case_spool_bitmap            ,
+    &iter_case_spool_bitmap          ,
+    &bulk_case_spool_bitmap          ,
+    &handle_case_spool_bitmap        ,
+    &parallel_case_spool_bitmap      ,
+    &snapshot_case_spool_bitmap      ,
 
     &base_case_spool_dlist           ,
     &ex_case_spool_dlist             ,
     &iter_case_spool_dlist           ,
+    &bulk_case_spool_dlist           ,
+    &handle_case_spool_dlist         ,
+    &stats_case_spool_dlist          ,
+    &parallel_case_spool_dlist       ,
+    &snapshot_case_spool_dlist       ,
+    &lazy_case_spool_dlist           ,
+    &split_case_spool_dlist          ,
+
+    &base_case_spool_idlist          ,
+    &ex_case_spool_idlist            ,
+    &iter_case_spool_idlist          ,
+    &bulk_case_spool_idlist          ,
+    &handle_case_spool_idlist        ,
+    &relocate_case_spool_idlist      ,
+    &split_case_spool_idlist         ,
+    &parallel_case_spool_idlist      ,
+    &snapshot_case_spool_idlist      ,
+    &stats_case_spool_idlist         ,
+
+    &base_case_spool_shared          ,
+    &mt_case_spool_shared            ,
+    &bulk_case_spool_shared          ,
+    &shared_case_spool_shared        ,
 
 
     &base_case_pool_list             ,
     &ex_dinamic_case_pool_list       ,
+    &bulk_case_pool_list             ,
+    &src_case_pool_list              ,
+    &stats_case_pool_list            ,
 
     &base_case_pool_list_block       ,
     &ex_dinamic_case_pool_list_block ,
+    &bulk_case_pool_list_block       ,
+    &src_case_pool_list_block        ,
+    &trim_case_pool_list_block       ,
+    &handle_case_pool_list_block     ,
+    &stats_case_pool_list_block      ,
 
     &base_case_pool_dlist            ,
     &ex_case_pool_dlist              ,
     &ex_dinamic_case_pool_dlist      ,
     &iter_case_pool_dlist            ,
+    &bulk_case_pool_dlist            ,
+    &src_case_pool_dlist             ,
+    &stats_case_pool_dlist           ,
+    &parallel_case_pool_dlist        ,
 
     &base_case_pool_dlist_block      ,
     &ex_case_pool_dlist_block        ,
     &ex_dinamic_case_pool_dlist_block,
     &iter_case_pool_dlist_block      ,
+    &bulk_case_pool_dlist_block      ,
+    &src_case_pool_dlist_block       ,
+    &trim_case_pool_dlist_block      ,
+    &handle_case_pool_dlist_block    ,
+    &stats_case_pool_dlist_block     ,
+    &parallel_case_pool_dlist_block  ,
+    &compact_case_pool_dlist_block   ,
+    &snapshot_case_pool_dlist_block  ,
+    &split_case_pool_dlist_block     ,
+
+    &base_case_pool_list_mt            ,
+    &ex_dinamic_case_pool_list_mt      ,
+    &mt_case_pool_list_mt              ,
+    &bulk_case_pool_list_mt            ,
+    &src_case_pool_list_mt             ,
+
+    &base_case_pool_list_block_mt      ,
+    &ex_dinamic_case_pool_list_block_mt,
+    &mt_case_pool_list_block_mt        ,
+    &bulk_case_pool_list_block_mt      ,
+    &src_case_pool_list_block_mt       ,
+
+    &mag_case_pool_list_block          ,
+    &mag_case_pool_dlist_block         ,
+
+    &pmr_case_pool_list_block          ,
+    &pmr_case_pool_dlist_block         ,
+
+    &alloc_case_pool_list_block        ,
+    &alloc_case_pool_list_block_mt     ,
+
+    &sc_case_pool_list_block           ,
+    &sc_case_pool_dlist_block          ,
 };
 
 
@@ -0,0 +1,150 @@
+#ifndef MT_TESTS_H
+#define MT_TESTS_H
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "stest.h"
+#include "helpers.h"
+#include "pool.h"
+
+
+
+
+using namespace pool;
+
+
+
+
+static const size_t MT_THREADS = 8;
+static const size_t MT_ITERS   = 20000;
+static const size_t MT_BATCH   = 16;
+
+
+
+
+//Each thread creates a batch of objects, marks them with own tag,
+//checks the tags (nobody else got the same node) and destroys them.
+template <class P>
+static size_t mt_stress(P &pool)
+{
+    std::atomic<size_t> errors{0};
+    std::vector<std::thread> threads;
+
+    for(size_t t = 0; t < MT_THREADS; t++)
+    {
+        threads.emplace_back([&pool, &errors, t]()
+        {
+            std::array<size_t*, MT_BATCH> objs;
+
+            for(size_t i = 0; i < MT_ITERS; i++)
+            {
+                size_t tag = t * MT_ITERS + i;
+                size_t cnt = 0;
+
+                for(auto &obj: objs)
+                {
+                    obj = pool.create(tag);
+                    if(obj)
+                        cnt++;
+                }
+
+                for(auto obj: objs)
+                {
+                    if(obj && *obj != tag)
+                        errors++;
+                }
+
+                for(auto obj: objs)
+                    pool.destroy(obj);
+
+                if(cnt == 0)
+                    std::this_thread::yield();
+            }
+        });
+    }
+
+    for(auto &thread: threads)
+        thread.join();
+
+    return errors;
+}
+
+
+
+TEST(mt_test_pool_stress)
+{
+    Pool<size_t, 64, alignof(size_t), 0, IMPL> pool;
+
+    TEST_ASSERT(mt_stress(pool) == 0);
+    TEST_ASSERT(pool.size()     == 0);
+    TEST_ASSERT(pool.capacity() >= MT_BATCH);
+    TEST_ASSERT(pool.capacity() <= MT_BATCH * MT_THREADS + 64);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(mt_test_pool_stress_fixed)
+{
+    const size_t N = MT_BATCH * MT_THREADS / 2; //threads compete for nodes
+    DECLARE_POOL(pool, size_t, N, alignof(size_t), POOL_FIXED_CAPACITY)
+
+    TEST_ASSERT(mt_stress(pool) == 0);
+    TEST_ASSERT(pool.size()     == 0);
+    TEST_ASSERT(pool.capacity() == N);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(mt_test_pool_stress_struct)
+{
+    TEST_ASSERT(Temp_struct::cnt == 0);
+
+    Pool<Temp_struct, 16, 16, 0, IMPL> pool;
+    std::vector<std::thread> threads;
+    std::atomic<size_t> errors{0};
+
+    for(size_t t = 0; t < MT_THREADS; t++)
+    {
+        threads.emplace_back([&pool, &errors, t]()
+        {
+            for(size_t i = 0; i < MT_ITERS; i++)
+            {
+                auto obj = pool.create((int)t);
+                if(!obj || obj->tag != (int)t)
+                    errors++;
+
+                pool.destroy(obj);
+            }
+        });
+    }
+
+    for(auto &thread: threads)
+        thread.join();
+
+    TEST_ASSERT(errors      == 0);
+    TEST_ASSERT(pool.size() == 0);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+
+static stest_func mt_tests[] =
+{
+    mt_test_pool_stress,
+    mt_test_pool_stress_fixed,
+    mt_test_pool_stress_struct,
+};
+
+
+
+
+
+#endif // MT_TESTS_H
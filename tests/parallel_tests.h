@@ -0,0 +1,203 @@
+#ifndef PARALLEL_TESTS_H
+#define PARALLEL_TESTS_H
+
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <stdexcept>
+
+#include "stest.h"
+#include "helpers.h"
+#include "pool.h"
+
+
+
+
+using namespace pool;
+
+
+
+//Temp_struct with the atomic counter (the dtors are called by several threads)
+struct Par_struct
+{
+    Par_struct(int val):tag(val) { cnt++; }
+    ~Par_struct()                { cnt--; }
+
+    static inline std::atomic<int> cnt{0};
+    int tag;
+};
+
+
+//The pool with holes: the objects with tag % 3 == 0 are destroyed
+template <class Pool_type>
+void fill_with_holes(Pool_type& pool, std::size_t n)
+{
+    std::vector<Par_struct*> objs(n);
+
+    for(std::size_t i = 0; i < n; i++)
+        objs[i] = pool.create(int(i));
+
+    for(std::size_t i = 0; i < n; i += 3)
+        pool.destroy(objs[i]);
+}
+
+
+static const std::size_t PAR_N = 8 * POOL_PARALLEL_GRAIN;
+
+
+
+
+TEST(parallel_test_for_each)
+{
+    using Pool_type = Pool<Par_struct, PAR_N, alignof(Par_struct), 0, IMPL>;
+
+    auto pool = std::make_unique<Pool_type>(); //the static pools are big for the stack
+#ifdef NEED_RESERVE
+    pool->reserve(PAR_N);
+#endif
+    fill_with_holes(*pool, PAR_N);
+
+    std::vector<int>        hits(PAR_N, 0); //each object has own cell
+    std::atomic<std::size_t> cnt{0};
+
+    pool->parallel_for_each([&](Par_struct* obj){ hits[obj->tag]++; cnt++; }, 4);
+
+    TEST_ASSERT(cnt == pool->size());
+
+    for(std::size_t i = 0; i < PAR_N; i++)
+        TEST_ASSERT(hits[i] == (i % 3 ? 1 : 0));
+
+
+    //the small pool is walked by the caller
+    Pool_type small;
+#ifdef NEED_RESERVE
+    small.reserve(16);
+#endif
+    fill_with_holes(small, 16);
+    cnt = 0;
+
+    small.parallel_for_each([&](Par_struct*){ cnt++; });
+    TEST_ASSERT(cnt == small.size());
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(parallel_test_executor)
+{
+    using Pool_type = Pool<Par_struct, PAR_N, alignof(Par_struct), 0, IMPL>;
+
+    auto pool = std::make_unique<Pool_type>();
+#ifdef NEED_RESERVE
+    pool->reserve(PAR_N);
+#endif
+    fill_with_holes(*pool, PAR_N);
+
+    std::size_t parts = 0;
+    std::size_t cnt   = 0;
+
+    //the executor runs the parts in the caller
+    pool->parallel_for_each([&](Par_struct*){ cnt++; },
+                            [&](std::size_t n, auto& task)
+                            {
+                                parts = n;
+                                for(std::size_t i = 0; i < n; i++)
+                                    task(i);
+                            });
+
+    TEST_ASSERT(parts > 1);
+    TEST_ASSERT(cnt == pool->size());
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(parallel_test_exception)
+{
+    using Pool_type = Pool<Par_struct, PAR_N, alignof(Par_struct), 0, IMPL>;
+
+    auto pool = std::make_unique<Pool_type>();
+#ifdef NEED_RESERVE
+    pool->reserve(PAR_N);
+#endif
+    fill_with_holes(*pool, PAR_N);
+
+    bool thrown = false;
+
+    try
+    {
+        pool->parallel_for_each([](Par_struct* obj)
+        {
+            if(obj->tag == int(PAR_N / 2 + 1))
+                throw std::runtime_error("tag");
+        }, 4);
+    }
+    catch(const std::runtime_error&)
+    {
+        thrown = true;
+    }
+
+    TEST_ASSERT(thrown);
+    TEST_ASSERT(pool->size() == PAR_N - (PAR_N + 2) / 3);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(parallel_test_destroy_all)
+{
+    using Pool_type = Pool<Par_struct, PAR_N, alignof(Par_struct), 0, IMPL>;
+
+    Par_struct::cnt = 0;
+
+    auto pool = std::make_unique<Pool_type>();
+#ifdef NEED_RESERVE
+    pool->reserve(PAR_N);
+#endif
+    fill_with_holes(*pool, PAR_N);
+
+    TEST_ASSERT(Par_struct::cnt == int(pool->size()));
+
+    pool->parallel_destroy_all(4);
+
+    TEST_ASSERT(Par_struct::cnt == 0);
+    TEST_ASSERT(pool->empty());
+    TEST_ASSERT(pool->begin() == pool->end());
+
+    //all nodes are free again
+    std::vector<Par_struct*> objs(PAR_N);
+
+    for(std::size_t i = 0; i < PAR_N; i++)
+    {
+        objs[i] = pool->create(int(i));
+        TEST_ASSERT(objs[i]);
+    }
+
+    TEST_ASSERT(pool->size() == PAR_N);
+    TEST_ASSERT(std::distance(pool->begin(), pool->end()) == std::ptrdiff_t(PAR_N));
+
+    pool->destroy_all();
+    TEST_ASSERT(Par_struct::cnt == 0);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+
+static stest_func parallel_tests[] =
+{
+    parallel_test_for_each,
+    parallel_test_executor,
+    parallel_test_exception,
+    parallel_test_destroy_all,
+};
+
+
+
+
+
+#endif // PARALLEL_TESTS_H
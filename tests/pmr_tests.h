@@ -0,0 +1,197 @@
+#ifndef PMR_TESTS_H
+#define PMR_TESTS_H
+
+#include "stest.h"
+#include "helpers.h"
+#include "pool.h"
+
+#if defined(POOL_MEMORY_RESOURCE)
+    #include <list>
+    #include <unordered_map>
+    #include <vector>
+#endif
+
+
+
+
+using namespace pool;
+
+
+
+
+#if defined(POOL_MEMORY_RESOURCE)
+
+//Upstream resource which counts the live allocations
+struct Counting_resource: public std::pmr::memory_resource
+{
+    size_t cnt = 0;
+
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        cnt++;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override
+    {
+        cnt--;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+#endif
+
+
+
+TEST(pmr_test_allocate)
+{
+#if defined(POOL_MEMORY_RESOURCE)
+    Counting_resource upstream;
+    pool_memory_resource<64, 16, 8, 0, IMPL> mr(&upstream);
+
+    TEST_ASSERT(mr.upstream_resource() == &upstream);
+    TEST_ASSERT(mr.is_equal(mr));
+
+    std::array<void*, 20> ptrs;
+
+    for(size_t i = 0; i < ptrs.size(); i++)
+    {
+        ptrs[i] = mr.allocate(i % 2 ? 64 : 1, i % 2 ? 16 : 1);
+        TEST_ASSERT(ptrs[i] != nullptr);
+        TEST_ASSERT((std::uintptr_t)(ptrs[i])%16 == 0);
+    }
+
+    TEST_ASSERT(mr.pool().size() == ptrs.size());
+    TEST_ASSERT(upstream.cnt     == 0);
+
+    for(size_t i = 0; i < ptrs.size(); i++)
+        mr.deallocate(ptrs[i], i % 2 ? 64 : 1, i % 2 ? 16 : 1);
+
+    TEST_ASSERT(mr.pool().size() == 0);
+
+    TEST_PASS(nullptr);
+#else
+    TEST_SKIP("<memory_resource> is not available");
+#endif
+}
+
+
+
+TEST(pmr_test_upstream)
+{
+#if defined(POOL_MEMORY_RESOURCE)
+    Counting_resource upstream;
+    pool_memory_resource<64, 16, 8, 0, IMPL> mr(&upstream);
+
+    auto big     = mr.allocate(65, 16); //size is greater than Size
+    auto aligned = mr.allocate(16, 32); //alignment is greater than Align
+
+    TEST_ASSERT(big     != nullptr);
+    TEST_ASSERT(aligned != nullptr);
+    TEST_ASSERT((std::uintptr_t)(aligned)%32 == 0);
+    TEST_ASSERT(upstream.cnt     == 2);
+    TEST_ASSERT(mr.pool().size() == 0);
+
+    mr.deallocate(big,     65, 16);
+    mr.deallocate(aligned, 16, 32);
+
+    TEST_ASSERT(upstream.cnt == 0);
+
+    TEST_PASS(nullptr);
+#else
+    TEST_SKIP("<memory_resource> is not available");
+#endif
+}
+
+
+
+TEST(pmr_test_fixed_capacity)
+{
+#if defined(POOL_MEMORY_RESOURCE)
+    pool_memory_resource<64, 16, 8, POOL_FIXED_CAPACITY, IMPL> mr;
+    mr.pool().reserve(2); //Pool_xxx_block reserves the whole block
+
+    std::vector<void*> ptrs;
+
+    while(!mr.pool().full())
+        ptrs.push_back(mr.allocate(64, 16));
+
+    TEST_ASSERT(ptrs.size() == mr.pool().capacity());
+
+    bool is_throw = false;
+
+    try {
+        ptrs.push_back(mr.allocate(64, 16));
+    } catch (const std::bad_alloc &) {
+        is_throw = true;
+    }
+
+    TEST_ASSERT(is_throw == true);
+
+    for(auto p: ptrs)
+        mr.deallocate(p, 64, 16);
+
+    TEST_ASSERT(mr.pool().size() == 0);
+
+    TEST_PASS(nullptr);
+#else
+    TEST_SKIP("<memory_resource> is not available");
+#endif
+}
+
+
+
+TEST(pmr_test_containers)
+{
+#if defined(POOL_MEMORY_RESOURCE)
+    Counting_resource upstream;
+    pool_memory_resource<64, alignof(std::max_align_t), 16, 0, IMPL> mr(&upstream);
+
+    {
+        std::pmr::list<int> list(&mr);
+
+        for(int i = 0; i < 100; i++)
+            list.push_back(i);
+
+        TEST_ASSERT(mr.pool().size() == 100); //all nodes are from the pool
+        TEST_ASSERT(upstream.cnt     == 0);
+
+        std::pmr::unordered_map<int, int> map(&mr);
+
+        for(int i = 0; i < 100; i++)
+            map[i] = i;
+
+        TEST_ASSERT(mr.pool().size() >= 200); //the buckets go to upstream (if they're big)
+        TEST_ASSERT(map.at(42) == 42);
+    }
+
+    TEST_ASSERT(mr.pool().size() == 0);
+    TEST_ASSERT(upstream.cnt     == 0);
+
+    TEST_PASS(nullptr);
+#else
+    TEST_SKIP("<memory_resource> is not available");
+#endif
+}
+
+
+
+
+static stest_func pmr_tests[] =
+{
+    pmr_test_allocate,
+    pmr_test_upstream,
+    pmr_test_fixed_capacity,
+    pmr_test_containers,
+};
+
+
+
+
+
+#endif // PMR_TESTS_H
@@ -0,0 +1,247 @@
+#ifndef RELOCATE_TESTS_H
+#define RELOCATE_TESTS_H
+
+#include <array>
+#include <string>
+#include <vector>
+#include <utility> //move
+
+#include "stest.h"
+#include "helpers.h"
+#include "pool.h"
+
+
+
+
+using namespace pool;
+
+
+
+//Temp_struct which counts the moved objects too
+struct Move_struct
+{
+    Move_struct(int val):             tag(val)       { cnt++; }
+    Move_struct(Move_struct&& other): tag(other.tag) { cnt++; other.tag = -1; }
+    ~Move_struct()                                   { cnt--; }
+
+    static inline int cnt = 0;
+    int tag;
+};
+
+
+//Move_struct which throws on the throw_on-th move
+struct Throw_move_struct
+{
+    Throw_move_struct(int val): tag(val) { cnt++; }
+    Throw_move_struct(Throw_move_struct&& other): tag(other.tag)
+    {
+        if(++moved == throw_on)
+            throw 1;
+        cnt++;
+    }
+    ~Throw_move_struct() { cnt--; }
+
+    static inline int cnt      = 0;
+    static inline int moved    = 0;
+    static inline int throw_on = 0;
+    int tag;
+};
+
+
+
+
+TEST(relocate_test_node_size)
+{
+    //the links are the 16-bit indices (4 bytes per node instead of 16)
+    TEST_ASSERT(sizeof(Pool<uint32_t, 65535, alignof(uint32_t), 0, IMPL>) < 65536 * 8 + 64);
+
+    //the 32-bit indices
+    TEST_ASSERT(sizeof(Pool<uint32_t, 65536, alignof(uint32_t), 0, IMPL>) < 65537 * 12 + 64);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(relocate_test_move)
+{
+    Move_struct::cnt = 0;
+
+    {
+        Pool<Move_struct, 16, alignof(Move_struct), 0, IMPL> pool;
+        std::array<Move_struct*, 16> objs;
+
+        for(int i = 0; i < 16; i++)
+            objs[i] = pool.create(i);
+
+        //the holes in the pool and in the order of used list
+        pool.destroy(objs[3]);
+        pool.destroy(objs[7]);
+        pool.destroy(objs[0]);
+        objs[0] = pool.create(100);
+        TEST_ASSERT(pool.size() == 14);
+
+        //move ctor
+        auto pool2(std::move(pool));
+        TEST_ASSERT(pool.size()      == 0);
+        TEST_ASSERT(pool2.size()     == 14);
+        TEST_ASSERT(Move_struct::cnt == 14);
+
+        std::vector<int> tags;
+        for(auto &obj: pool2)
+            tags.push_back(obj.tag);
+
+        TEST_ASSERT((tags == std::vector<int>{1, 2, 4, 5, 6, 8, 9, 10, 11, 12, 13, 14, 15, 100}));
+
+        //the moved from pool is empty and usable
+        for(int i = 0; i < 16; i++)
+            TEST_ASSERT(pool.create(i));
+
+        TEST_ASSERT(pool.full());
+        TEST_ASSERT(Move_struct::cnt == 30);
+
+        //move operator= (the objects of pool are destroyed)
+        pool = std::move(pool2);
+        TEST_ASSERT(pool.size()      == 14);
+        TEST_ASSERT(pool2.size()     == 0);
+        TEST_ASSERT(Move_struct::cnt == 14);
+
+        //the free nodes are moved too
+        TEST_ASSERT(pool.create(200));
+        TEST_ASSERT(pool.create(201));
+        TEST_ASSERT(pool.full());
+        TEST_ASSERT(!pool.create(202));
+
+        tags.clear();
+        for(auto &obj: pool)
+            tags.push_back(obj.tag);
+
+        TEST_ASSERT((tags == std::vector<int>{1, 2, 4, 5, 6, 8, 9, 10, 11, 12, 13, 14, 15, 100, 200, 201}));
+    }
+
+    TEST_ASSERT(Move_struct::cnt == 0);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(relocate_test_container)
+{
+    using Str_pool = Pool<std::string, 8, alignof(std::string), 0, IMPL>;
+
+    std::vector<Str_pool> pools;
+
+    for(int i = 0; i < 10; i++) //the vector is reallocated
+    {
+        pools.emplace_back();
+        pools.back().create(std::string(32, char('a' + i))); //not SSO
+        pools.back().create("x");
+    }
+
+    for(int i = 0; i < 10; i++)
+    {
+        TEST_ASSERT(pools[i].size() == 2);
+        TEST_ASSERT(*pools[i].begin()    == std::string(32, char('a' + i)));
+        TEST_ASSERT(*(++pools[i].begin()) == "x");
+    }
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(relocate_test_handles)
+{
+    Move_struct::cnt = 0;
+
+    Pool<Move_struct, 64, alignof(Move_struct), POOL_HANDLES, IMPL> pool;
+
+    auto h1 = pool.create_handle(1);
+    auto h2 = pool.create_handle(2);
+    pool.destroy(h1);
+
+    auto pool2 = std::move(pool);
+    TEST_ASSERT(pool2.get(h1)      == nullptr);
+    TEST_ASSERT(pool2.get(h2)->tag == 2);
+    TEST_ASSERT(pool.get(h2)       == nullptr);
+
+    pool2.destroy(h2);
+    TEST_ASSERT(Move_struct::cnt == 0);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+
+//The moved objects are destroyed if the move of the next one throws
+TEST(relocate_test_move_except)
+{
+    Throw_move_struct::cnt      = 0;
+    Throw_move_struct::moved    = 0;
+    Throw_move_struct::throw_on = 4;
+
+    Pool<Throw_move_struct, 16, alignof(Throw_move_struct), 0, IMPL> pool;
+
+    for(int i = 0; i < 8; i++)
+        pool.create(i);
+
+    try
+    {
+        auto pool2 = std::move(pool);
+        TEST_FAIL(nullptr);
+    }
+    catch(int)
+    {
+    }
+
+    TEST_ASSERT(Throw_move_struct::cnt == 8);
+    TEST_ASSERT(pool.size()            == 8);
+
+    //the assignment
+    Pool<Throw_move_struct, 16, alignof(Throw_move_struct), 0, IMPL> pool3;
+    pool3.create(100);
+
+    Throw_move_struct::moved = 0;
+
+    try
+    {
+        pool3 = std::move(pool);
+        TEST_FAIL(nullptr);
+    }
+    catch(int)
+    {
+    }
+
+    TEST_ASSERT(Throw_move_struct::cnt == 8);
+    TEST_ASSERT(pool3.empty());
+
+    Throw_move_struct::throw_on = 0;
+    pool3 = std::move(pool);
+    TEST_ASSERT(pool3.size()           == 8);
+    TEST_ASSERT(Throw_move_struct::cnt == 8);
+
+    pool3.destroy_all();
+    TEST_ASSERT(Throw_move_struct::cnt == 0);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+
+static stest_func relocate_tests[] =
+{
+    relocate_test_node_size,
+    relocate_test_move,
+    relocate_test_container,
+    relocate_test_handles,
+    relocate_test_move_except,
+};
+
+
+
+
+
+#endif // RELOCATE_TESTS_H
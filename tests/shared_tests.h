@@ -0,0 +1,218 @@
+#ifndef SHARED_TESTS_H
+#define SHARED_TESTS_H
+
+#include <cstdio>
+#include <vector>
+
+#if defined(POOL_MMAP)
+    #include <sys/wait.h>
+    #include <unistd.h>
+#endif
+
+#include "stest.h"
+#include "helpers.h"
+#include "pool.h"
+
+
+
+
+using namespace pool;
+
+
+
+
+struct Shared_msg
+{
+    Shared_msg(std::size_t val): tag(val), value(val * 3) {}
+
+    std::size_t tag;
+    std::size_t value;
+};
+
+
+static const char SHARED_PATH[] = "pool_shared_test.bin";
+
+static const std::size_t SHARED_N     = 256;
+static const std::size_t SHARED_ITERS = 20000;
+static const std::size_t SHARED_BATCH = 16;
+
+
+
+
+TEST(shared_test_index)
+{
+    DECLARE_POOL(pool, Shared_msg, 8, alignof(Shared_msg), 0);
+
+    std::vector<Shared_msg*> objs;
+
+    for(std::size_t i = 0; i < 8; i++)
+        objs.push_back(pool.create(i));
+
+    for(auto obj: objs)
+    {
+        const auto index = pool.index_of(obj);
+
+        TEST_ASSERT(index < 8);
+        TEST_ASSERT(pool.at_index(index) == obj);
+    }
+
+    TEST_ASSERT(pool.at_index(8) == nullptr);
+
+    pool.destroy_n(objs.data(), objs.size());
+    TEST_ASSERT(pool.empty());
+
+    TEST_PASS(nullptr);
+}
+
+
+
+#if defined(POOL_MMAP)
+//Each process creates a batch of objects, marks them with own tag,
+//checks the tags (nobody else got the same node) and destroys them.
+template <class P>
+static std::size_t shared_stress(P &pool, std::size_t id)
+{
+    std::size_t errors = 0;
+    std::array<Shared_msg*, SHARED_BATCH> objs;
+
+    for(std::size_t i = 0; i < SHARED_ITERS; i++)
+    {
+        const std::size_t tag = id * SHARED_ITERS + i;
+
+        for(auto &obj: objs)
+            obj = pool.create(tag);
+
+        for(auto obj: objs)
+        {
+            if(obj && (obj->tag != tag || obj->value != tag * 3))
+                errors++;
+        }
+
+        pool.destroy_n(objs.data(), objs.size());
+    }
+
+    return errors;
+}
+
+
+
+TEST(shared_test_processes)
+{
+    using Pool_type = Pool<Shared_msg, SHARED_N, alignof(Shared_msg), 0, IMPL>;
+
+    Pool_mapped<Pool_type> mapped;
+    TEST_ASSERT(mapped.create(SHARED_PATH));
+    TEST_ASSERT(mapped->empty());
+
+    //the message for the consumer: it's found by its index
+    auto msg = mapped->create(std::size_t(42));
+    const auto index = mapped->index_of(msg);
+
+    const std::size_t PROCESSES = 4;
+    std::vector<pid_t> pids;
+
+    for(std::size_t id = 0; id < PROCESSES; id++)
+    {
+        const pid_t pid = fork();
+        TEST_ASSERT(pid >= 0);
+
+        if(pid == 0)
+        {
+            //the own mapping of child (other address)
+            Pool_mapped<Pool_type> pool(SHARED_PATH, true);
+
+            std::size_t errors = pool ? shared_stress(*pool, id) : 1;
+
+            if(id == 0)
+            {
+                auto obj = pool ? pool->at_index(index) : nullptr;
+
+                if(!obj || obj->tag != 42)
+                    errors++;
+                else
+                    pool->destroy(obj); //the consumer releases the message
+            }
+
+            _exit(errors ? 1 : 0);
+        }
+
+        pids.push_back(pid);
+    }
+
+    const std::size_t errors = shared_stress(*mapped, PROCESSES);
+
+    for(auto pid: pids)
+    {
+        int status = 0;
+        TEST_ASSERT(waitpid(pid, &status, 0) == pid);
+        TEST_ASSERT(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+
+    TEST_ASSERT(errors == 0);
+    TEST_ASSERT(mapped->empty());
+
+    //all nodes are in the free list
+    std::vector<Shared_msg*> objs(SHARED_N + 1);
+    TEST_ASSERT(mapped->create_n(objs.data(), objs.size(), std::size_t(1)) == SHARED_N);
+    TEST_ASSERT(mapped->full());
+
+    mapped.close();
+    std::remove(SHARED_PATH);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(shared_test_reopen)
+{
+    using Pool_type  = Pool<Shared_msg, SHARED_N,     alignof(Shared_msg), 0, IMPL>;
+    using Other_pool = Pool<Shared_msg, SHARED_N * 2, alignof(Shared_msg), 0, IMPL>;
+
+    {
+        Pool_mapped<Pool_type> mapped;
+        TEST_ASSERT(mapped.create(SHARED_PATH));
+
+        for(std::size_t i = 0; i < 10; i++)
+            mapped->create(i);
+
+        TEST_ASSERT(mapped.sync());
+    }
+
+    TEST_ASSERT(!Pool_mapped<Other_pool>(SHARED_PATH, true));
+
+    Pool_mapped<Pool_type> mapped(SHARED_PATH, true);
+    TEST_ASSERT(mapped);
+    TEST_ASSERT(mapped->size() == 10);
+
+    for(std::size_t i = 0; i < 10; i++)
+        TEST_ASSERT(mapped->at_index(i)->tag == i);
+
+    //create() removes the old pool
+    TEST_ASSERT(mapped.create(SHARED_PATH));
+    TEST_ASSERT(mapped->empty());
+
+    mapped.close();
+    std::remove(SHARED_PATH);
+
+    TEST_PASS(nullptr);
+}
+#endif // POOL_MMAP
+
+
+
+
+static stest_func shared_tests[] =
+{
+    shared_test_index,
+#if defined(POOL_MMAP)
+    shared_test_processes,
+    shared_test_reopen,
+#endif
+};
+
+
+
+
+
+#endif // SHARED_TESTS_H
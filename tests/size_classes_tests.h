@@ -0,0 +1,174 @@
+#ifndef SIZE_CLASSES_TESTS_H
+#define SIZE_CLASSES_TESTS_H
+
+#include <cstring>
+#include <vector>
+
+#include "stest.h"
+#include "helpers.h"
+#include "pool.h"
+
+
+
+
+using namespace pool;
+
+
+
+
+TEST(sc_test_size_class)
+{
+    using Heap = Pool_size_classes<16, 0, IMPL>; //16, 32, 64, 128, 256, 512
+
+    TEST_STATIC_ASSERT(Heap::CLASSES  == 6);
+    TEST_STATIC_ASSERT(Heap::MAX_SIZE == 512);
+
+    TEST_STATIC_ASSERT(Heap::size_class(0,   1)  == 0);
+    TEST_STATIC_ASSERT(Heap::size_class(1,   1)  == 0);
+    TEST_STATIC_ASSERT(Heap::size_class(16,  8)  == 0);
+    TEST_STATIC_ASSERT(Heap::size_class(17,  1)  == 1);
+    TEST_STATIC_ASSERT(Heap::size_class(100, 16) == 3);
+    TEST_STATIC_ASSERT(Heap::size_class(512, 1)  == 5);
+    TEST_STATIC_ASSERT(Heap::size_class(513, 1)  == Heap::CLASSES); //too big
+    TEST_STATIC_ASSERT(Heap::size_class(8,   64) == 2);             //by alignment
+
+    using Heap2 = Pool_size_classes<16, 0, IMPL, 24, 48, 96>;
+
+    TEST_STATIC_ASSERT(Heap2::class_align(0) == 8);
+    TEST_STATIC_ASSERT(Heap2::class_align(1) == 16);
+    TEST_STATIC_ASSERT(Heap2::class_align(2) == 32);
+    TEST_STATIC_ASSERT(Heap2::size_class(20, 8)  == 0);
+    TEST_STATIC_ASSERT(Heap2::size_class(20, 16) == 1); //24 isn't aligned to 16
+    TEST_STATIC_ASSERT(Heap2::size_class(20, 32) == 2);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(sc_test_allocate)
+{
+    Pool_size_classes<16, 0, IMPL> heap;
+
+    struct Request { size_t bytes, align; void* p; };
+    std::vector<Request> requests;
+
+    for(size_t bytes = 1; bytes <= 600; bytes += 7)
+        requests.push_back({bytes, bytes % 3 ? 8u : 16u, nullptr});
+
+    for(auto &r: requests)
+    {
+        r.p = heap.allocate(r.bytes, r.align);
+        TEST_ASSERT(r.p != nullptr);
+        TEST_ASSERT((std::uintptr_t)(r.p) % r.align == 0);
+        std::memset(r.p, 0xAA, r.bytes);
+    }
+
+    size_t big = 0;
+    for(auto &r: requests)
+        big += r.bytes > 512;
+
+    TEST_ASSERT(heap.size() == requests.size() - big); //big requests go to operator new
+    TEST_ASSERT(heap.pool<0>().size() == 3);           //1, 8, 15
+
+    for(auto &r: requests)
+        heap.deallocate(r.p, r.bytes, r.align);
+
+    TEST_ASSERT(heap.size() == 0);
+
+    heap.shrink_to_fit();
+    TEST_ASSERT(heap.capacity() == 0);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(sc_test_create)
+{
+    TEST_ASSERT(Temp_struct::cnt == 0);
+
+    Pool_size_classes<16, 0, IMPL> heap;
+
+    std::array<Temp_struct*, 20> objs;
+
+    for(size_t i = 0; i < objs.size(); i++)
+    {
+        objs[i] = heap.create<Temp_struct>((int)i);
+        TEST_ASSERT(objs[i] != nullptr);
+        TEST_ASSERT(objs[i]->tag == (int)i);
+    }
+
+    TEST_ASSERT(Temp_struct::cnt     == (int)objs.size());
+    TEST_ASSERT(heap.pool<0>().size() == objs.size());
+
+    for(auto obj: objs)
+        heap.destroy(obj);
+
+    TEST_ASSERT(Temp_struct::cnt == 0);
+    TEST_ASSERT(heap.size()      == 0);
+
+
+    //strong exception guarantee
+    struct Throw_ctor
+    {
+        char data[100];
+        Throw_ctor() { throw 1; }
+    };
+
+    bool is_throw = false;
+
+    try {
+        heap.create<Throw_ctor>();
+    } catch (int) {
+        is_throw = true;
+    }
+
+    TEST_ASSERT(is_throw    == true);
+    TEST_ASSERT(heap.size() == 0);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(sc_test_fixed_capacity)
+{
+    Pool_size_classes<4, POOL_FIXED_CAPACITY, IMPL> heap;
+
+    TEST_ASSERT(heap.allocate(16) == nullptr); //no nodes
+
+    heap.pool<0>().reserve(4);
+
+    std::vector<void*> ptrs;
+
+    while(auto p = heap.allocate(16))
+        ptrs.push_back(p);
+
+    TEST_ASSERT(ptrs.size() == heap.pool<0>().capacity());
+    TEST_ASSERT(heap.allocate(32) == nullptr); //the other class has no nodes
+
+    for(auto p: ptrs)
+        heap.deallocate(p, 16);
+
+    TEST_ASSERT(heap.size() == 0);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+
+static stest_func sc_tests[] =
+{
+    sc_test_size_class,
+    sc_test_allocate,
+    sc_test_create,
+    sc_test_fixed_capacity,
+};
+
+
+
+
+
+#endif // SIZE_CLASSES_TESTS_H
@@ -0,0 +1,213 @@
+#ifndef SNAPSHOT_TESTS_H
+#define SNAPSHOT_TESTS_H
+
+#include <cstdio>
+#include <vector>
+
+#include "stest.h"
+#include "helpers.h"
+#include "pool.h"
+
+
+
+
+using namespace pool;
+
+
+
+
+struct Snap_struct
+{
+    Snap_struct(int val): tag(val), value(val * 0.5) {}
+
+    int    tag;
+    double value;
+};
+
+
+static const char SNAPSHOT_PATH[] = "pool_snapshot_test.bin";
+
+
+//The pool with holes: the objects with tag % 4 == 0 are destroyed
+template <class Pool_type>
+std::vector<int> fill_snapshot(Pool_type& pool, int n)
+{
+    std::vector<Snap_struct*> objs;
+
+    for(int i = 0; i < n; i++)
+        objs.push_back(pool.create(i));
+
+    for(int i = 0; i < n; i += 4)
+        pool.destroy(objs[i]);
+
+    std::vector<int> tags;
+    for(auto &obj: pool)
+        tags.push_back(obj.tag);
+
+    return tags;
+}
+
+
+template <class Pool_type>
+std::vector<int> tags_of(Pool_type& pool)
+{
+    std::vector<int> tags;
+    for(auto &obj: pool)
+        tags.push_back(obj.tag);
+
+    return tags;
+}
+
+
+
+
+//The image pools are mapped back, the others are loaded
+template <std::size_t N>
+static struct test_info_t snapshot_roundtrip(struct test_case_t *test_case)
+{
+    using Pool_type = Pool<Snap_struct, N, alignof(Snap_struct), 0, IMPL>;
+
+    DECLARE_POOL(pool, Snap_struct, N, alignof(Snap_struct), 0);
+
+    const auto tags = fill_snapshot(pool, 40);
+    TEST_ASSERT(pool_save(pool, SNAPSHOT_PATH));
+
+    if constexpr(pool_impl::pool_has_image<Pool_type>)
+    {
+#if defined(POOL_MMAP)
+        //the private mapping: the file isn't changed
+        {
+            Pool_mapped<Pool_type> mapped(SNAPSHOT_PATH);
+            TEST_ASSERT(mapped);
+            TEST_ASSERT(mapped->size()  == pool.size());
+            TEST_ASSERT(tags_of(*mapped) == tags);
+
+            auto obj = mapped->create(100);
+            TEST_ASSERT(obj && obj->value == 50.0);
+            TEST_ASSERT(mapped->size() == pool.size() + 1);
+        }
+
+        //the shared mapping: the changes are in the file
+        {
+            Pool_mapped<Pool_type> mapped;
+            TEST_ASSERT(mapped.open(SNAPSHOT_PATH, true));
+            TEST_ASSERT(mapped->size() == pool.size());
+
+            mapped->create(100);
+            TEST_ASSERT(mapped.sync());
+        }
+
+        Pool_mapped<Pool_type> mapped(SNAPSHOT_PATH);
+        TEST_ASSERT(mapped->size() == pool.size() + 1);
+#endif
+    }
+    else
+    {
+        DECLARE_POOL(pool2, Snap_struct, N, alignof(Snap_struct), 0);
+
+        TEST_ASSERT(pool_load(pool2, SNAPSHOT_PATH) == pool.size());
+        TEST_ASSERT(pool2.size()   == pool.size());
+        TEST_ASSERT(tags_of(pool2) == tags);
+
+        for(auto &obj: pool2)
+            TEST_ASSERT(obj.value == obj.tag * 0.5);
+    }
+
+    std::remove(SNAPSHOT_PATH);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+template <std::size_t N>
+static struct test_info_t snapshot_reject(struct test_case_t *test_case)
+{
+    using Pool_type  = Pool<Snap_struct, N,     alignof(Snap_struct), 0, IMPL>;
+    using Other_pool = Pool<Snap_struct, N * 2, alignof(Snap_struct), 0, IMPL>;
+    using Other_type = Pool<int,         N,     alignof(int),         0, IMPL>;
+
+    DECLARE_POOL(pool, Snap_struct, N, alignof(Snap_struct), 0);
+    fill_snapshot(pool, 10);
+
+    TEST_ASSERT(pool_save(pool, SNAPSHOT_PATH));
+
+    if constexpr(pool_impl::pool_has_image<Pool_type>)
+    {
+#if defined(POOL_MMAP)
+        TEST_ASSERT(!Pool_mapped<Other_pool>(SNAPSHOT_PATH));
+        TEST_ASSERT(!Pool_mapped<Other_type>(SNAPSHOT_PATH));
+        TEST_ASSERT( Pool_mapped<Pool_type>(SNAPSHOT_PATH));
+
+        //the image isn't the objects
+        DECLARE_POOL(pool2, Snap_struct, N, alignof(Snap_struct), 0);
+        TEST_ASSERT(pool_load(pool2, SNAPSHOT_PATH) == 0);
+#endif
+    }
+    else
+    {
+        DECLARE_POOL(pool2, int, N, alignof(int), 0);
+        TEST_ASSERT(pool_load(pool2, SNAPSHOT_PATH) == 0);
+    }
+
+    //the other version of format
+    auto file = std::fopen(SNAPSHOT_PATH, "r+b");
+    TEST_ASSERT(file);
+
+    Pool_snapshot_header header;
+    TEST_ASSERT(std::fread(&header, sizeof(header), 1, file) == 1);
+
+    header.version++;
+    std::rewind(file);
+    TEST_ASSERT(std::fwrite(&header, sizeof(header), 1, file) == 1);
+    std::fclose(file);
+
+    if constexpr(pool_impl::pool_has_image<Pool_type>)
+    {
+#if defined(POOL_MMAP)
+        TEST_ASSERT(!Pool_mapped<Pool_type>(SNAPSHOT_PATH));
+#endif
+    }
+    else
+    {
+        DECLARE_POOL(pool2, Snap_struct, N, alignof(Snap_struct), 0);
+        TEST_ASSERT(pool_load(pool2, SNAPSHOT_PATH) == 0);
+    }
+
+    std::remove(SNAPSHOT_PATH);
+
+    //there is no file
+    DECLARE_POOL(pool3, Snap_struct, N, alignof(Snap_struct), 0);
+    TEST_ASSERT(pool_load(pool3, SNAPSHOT_PATH) == 0);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(snapshot_test_roundtrip)
+{
+    return snapshot_roundtrip<64>(test_case);
+}
+
+
+
+TEST(snapshot_test_reject)
+{
+    return snapshot_reject<64>(test_case);
+}
+
+
+
+
+static stest_func snapshot_tests[] =
+{
+    snapshot_test_roundtrip,
+    snapshot_test_reject,
+};
+
+
+
+
+
+#endif // SNAPSHOT_TESTS_H
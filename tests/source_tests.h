@@ -0,0 +1,180 @@
+#ifndef SOURCE_TESTS_H
+#define SOURCE_TESTS_H
+
+#include <vector>
+
+#include "stest.h"
+#include "helpers.h"
+#include "pool.h"
+
+
+
+
+using namespace pool;
+
+
+
+
+//Source which counts the live allocations (on top of the heap source)
+struct Counting_source
+{
+    size_t *cnt = nullptr;
+
+    void* allocate(size_t bytes, size_t align) noexcept
+    {
+        (*cnt)++;
+        return Pool_heap_source::allocate(bytes, align);
+    }
+
+    void deallocate(void* p, size_t bytes, size_t align) noexcept
+    {
+        (*cnt)--;
+        Pool_heap_source::deallocate(p, bytes, align);
+    }
+};
+
+
+
+TEST(src_test_buffer_source)
+{
+    TEST_ASSERT(Temp_struct::cnt == 0);
+
+    alignas(64) static std::byte buf[4096];
+    Pool<Temp_struct, 8, 16, 0, IMPL, Pool_buffer_source> pool(Pool_buffer_source(buf, sizeof(buf)));
+
+    TEST_ASSERT(pool.capacity()          == 0);
+    TEST_ASSERT(pool.source().used()      == 0);
+    TEST_ASSERT(pool.source().available() == sizeof(buf));
+
+    std::vector<Temp_struct*> objs;
+
+    for(int i = 0; ; i++)
+    {
+        auto obj = pool.create(i);
+        if(!obj)
+            break;
+
+        TEST_ASSERT((std::byte*)obj >= buf && (std::byte*)obj + sizeof(*obj) <= buf + sizeof(buf));
+        TEST_ASSERT((uintptr_t)obj % 16 == 0);
+        objs.push_back(obj);
+    }
+
+    TEST_ASSERT(objs.size()      >  0);
+    TEST_ASSERT(pool.size()      == objs.size());
+    TEST_ASSERT(Temp_struct::cnt == (int)objs.size());
+    TEST_ASSERT(pool.source().used() <= sizeof(buf));
+
+    for(size_t i = 0; i < objs.size(); i++)
+    {
+        TEST_ASSERT(objs[i]->tag == (int)i);
+        pool.destroy(objs[i]);
+    }
+
+    TEST_ASSERT(Temp_struct::cnt == 0);
+
+    //the nodes/blocks are given back in LIFO order, the buffer is free
+    pool.shrink_to_fit();
+    TEST_ASSERT(pool.capacity()     == 0);
+    TEST_ASSERT(pool.source().used() == 0);
+
+    //and it can be used again
+    auto obj = pool.create(1);
+    TEST_ASSERT(obj != nullptr);
+    TEST_ASSERT((std::byte*)obj >= buf && (std::byte*)obj < buf + sizeof(buf));
+    pool.destroy(obj);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(src_test_empty_buffer_source)
+{
+    Pool<Temp_struct, 8, 16, 0, IMPL, Pool_buffer_source> pool;
+
+    TEST_ASSERT(pool.create(1)   == nullptr);
+    TEST_ASSERT(pool.capacity()  == 0);
+    TEST_ASSERT(Temp_struct::cnt == 0);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(src_test_custom_source)
+{
+    size_t cnt = 0;
+
+    {
+        Pool<Temp_struct, 4, 32, 0, IMPL, Counting_source> pool(Counting_source{&cnt});
+
+        std::array<Temp_struct*, 10> objs;
+        for(auto &obj: objs)
+            obj = pool.create(1);
+
+        TEST_ASSERT(cnt > 0);
+        TEST_ASSERT(pool.size() == objs.size());
+
+        for(auto obj: objs)
+        {
+            TEST_ASSERT((uintptr_t)obj % 32 == 0);
+            pool.destroy(obj);
+        }
+    }
+
+    TEST_ASSERT(cnt              == 0); //all memory is given back to the source
+    TEST_ASSERT(Temp_struct::cnt == 0);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(src_test_move)
+{
+    size_t cnt1 = 0, cnt2 = 0;
+
+    {
+        Pool<Temp_struct, 4, 16, 0, IMPL, Counting_source> pool1(Counting_source{&cnt1});
+        Pool<Temp_struct, 4, 16, 0, IMPL, Counting_source> pool2(Counting_source{&cnt2});
+
+        pool1.reserve(4);
+        pool2.reserve(4);
+        TEST_ASSERT(cnt1 > 0 && cnt2 > 0);
+
+        //the memory of pool1 is released into own source, pool2 takes memory with the source
+        pool1 = std::move(pool2);
+        TEST_ASSERT(cnt1 == 0);
+        TEST_ASSERT(cnt2 > 0);
+        TEST_ASSERT(pool1.source().cnt == &cnt2);
+
+        Pool<Temp_struct, 4, 16, 0, IMPL, Counting_source> pool3(std::move(pool1));
+        TEST_ASSERT(pool3.source().cnt == &cnt2);
+
+        auto obj = pool3.create(3);
+        TEST_ASSERT(obj != nullptr);
+        pool3.destroy(obj);
+    }
+
+    TEST_ASSERT(cnt1 == 0);
+    TEST_ASSERT(cnt2 == 0);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+
+static stest_func src_tests[] =
+{
+    src_test_buffer_source,
+    src_test_empty_buffer_source,
+    src_test_custom_source,
+    src_test_move,
+};
+
+
+
+
+
+#endif // SOURCE_TESTS_H
@@ -0,0 +1,242 @@
+#ifndef SPLIT_TESTS_H
+#define SPLIT_TESTS_H
+
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include <utility> //move
+
+#include "stest.h"
+#include "helpers.h"
+#include "pool.h"
+
+
+
+
+using namespace pool;
+
+
+
+
+struct alignas(64) Line_struct
+{
+    int tag;
+};
+
+
+#define SPLIT_FLAGS POOL_SPLIT_NODES
+
+
+
+TEST(split_test_size)
+{
+    const size_t N = 64;
+
+#ifdef NEED_RESERVE
+    //the links are in the padding of node: 64 + 64 bytes per node
+    TEST_ASSERT((Pool<Line_struct, N, 64, 0, IMPL>::node_bytes() == 128));
+
+    //the objects are dense: 64 bytes per node + 16 bytes of links (two pointers)
+    TEST_ASSERT((Pool<Line_struct, N, 64, SPLIT_FLAGS, IMPL>::node_bytes() == 64 + 16));
+#else
+    //the links are in the padding of node: 64 + 64 bytes per node
+    TEST_ASSERT(sizeof(Pool<Line_struct, N, 64, 0, IMPL>) >= N * 128);
+
+    //the objects are dense: 64 bytes per node + 4 (16 for pointers) bytes of links
+    TEST_ASSERT(sizeof(Pool<Line_struct, N, 64, SPLIT_FLAGS, IMPL>) <= N * (64 + 16) + 128);
+#endif
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(split_test_create_destroy)
+{
+    const int N = 64;
+    DECLARE_POOL(pool, Line_struct, N, 64, SPLIT_FLAGS | POOL_FIXED_CAPACITY);
+    std::array<Line_struct*, N> objs;
+
+    for(int i = 0; i < N; i++)
+    {
+        objs[i] = pool.create(Line_struct{i});
+        TEST_ASSERT(objs[i]);
+        TEST_ASSERT(reinterpret_cast<std::uintptr_t>(objs[i]) % 64 == 0);
+    }
+
+    //the objects are dense
+    auto sorted = objs;
+    std::sort(sorted.begin(), sorted.end());
+
+    for(int i = 1; i < N; i++)
+        TEST_ASSERT((char *)sorted[i] - (char *)sorted[i - 1] == 64);
+
+    while(pool.create(Line_struct{N}))
+        ;
+
+    TEST_ASSERT(pool.full());
+
+    const auto extra = pool.size() - N;
+
+    for(int i = 0; i < N; i += 2)
+        pool.destroy(objs[i]);
+
+    std::vector<int> tags;
+    pool.for_each([&tags](Line_struct* obj) { tags.push_back(obj->tag); });
+
+    TEST_ASSERT(tags.size() == N/2 + extra);
+    for(auto tag: tags)
+        TEST_ASSERT(tag % 2 == 1 || tag == N);
+
+    //the reverse order of iterator
+    int prev = N + 1;
+    for(auto it = pool.rbegin(); it != pool.rend(); ++it)
+    {
+        TEST_ASSERT(it->tag < prev || it->tag == N);
+        prev = it->tag;
+    }
+
+    std::array<Line_struct*, N> objs2;
+    TEST_ASSERT(pool.create_n(objs2.data(), N, Line_struct{100}) == N/2);
+    TEST_ASSERT(pool.full());
+
+    pool.destroy(pool.begin(), pool.end());
+    TEST_ASSERT(pool.empty());
+
+    TEST_PASS(nullptr);
+}
+
+
+
+//SPool_idlist and Pool_dlist_block (SPool_dlist can't be moved)
+template <class Pool_type>
+static struct test_info_t split_move(struct test_case_t *test_case)
+{
+    if constexpr(std::is_move_constructible_v<Pool_type>)
+    {
+        Pool_type pool;
+
+        auto h1 = pool.create_handle(Line_struct{1});
+        auto h2 = pool.create_handle(Line_struct{2});
+        auto h3 = pool.create_handle(Line_struct{3});
+        pool.destroy(h2);
+
+        auto pool2 = std::move(pool);
+        TEST_ASSERT(pool.empty());
+        TEST_ASSERT(pool2.size()       == 2);
+        TEST_ASSERT(pool2.get(h1)->tag == 1);
+        TEST_ASSERT(pool2.get(h2)      == nullptr);
+        TEST_ASSERT(pool2.get(h3)->tag == 3);
+
+        std::vector<int> tags;
+        for(auto &obj: pool2)
+            tags.push_back(obj.tag);
+
+        TEST_ASSERT((tags == std::vector<int>{1, 3}));
+    }
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(split_test_move)
+{
+    return split_move<Pool<Line_struct, 16, 64, SPLIT_FLAGS | POOL_HANDLES, IMPL>>(test_case);
+}
+
+
+
+
+#ifdef NEED_RESERVE
+//The moved objects get the links of their new nodes, the order of objects is kept
+TEST(split_test_compact)
+{
+    Pool<Line_struct, 16, 64, SPLIT_FLAGS | POOL_TRIM_BLOCKS, IMPL> pool;
+    std::vector<Line_struct*> objs;
+
+    for(int i = 0; i < 200; i++)
+        objs.push_back(pool.create(Line_struct{i}));
+
+    for(int i = 0; i < 200; i++)
+    {
+        if(i % 4)
+            pool.destroy(objs[i]);
+    }
+
+    std::vector<int> tags;
+    for(auto &obj: pool)
+        tags.push_back(obj.tag);
+
+    const auto cap = pool.capacity();
+    TEST_ASSERT(pool.compact() > 0);
+    TEST_ASSERT(pool.capacity() < cap);
+    TEST_ASSERT(pool.size()     == 50);
+
+    std::vector<int> tags2;
+    for(auto &obj: pool)
+        tags2.push_back(obj.tag);
+
+    TEST_ASSERT(tags == tags2);
+
+    pool.destroy_all();
+    TEST_ASSERT(pool.empty());
+
+    TEST_PASS(nullptr);
+}
+
+
+
+//The blocks of different sizes: the links are found via the block of node
+TEST(split_test_grow)
+{
+    Pool<Line_struct, 16, 64, SPLIT_FLAGS | POOL_GROW_BLOCKS, IMPL> pool;
+    std::vector<Line_struct*> objs;
+
+    for(int i = 0; i < 200; i++)
+        objs.push_back(pool.create(Line_struct{i}));
+
+    for(int i = 1; i < 200; i += 2)
+        pool.destroy(objs[i]);
+
+    int tag = 0;
+    for(auto &obj: pool)
+    {
+        TEST_ASSERT(obj.tag == tag);
+        tag += 2;
+    }
+
+    TEST_ASSERT(tag == 200);
+
+    for(int i = 1; i < 200; i += 2)
+        TEST_ASSERT(pool.create(Line_struct{i}));
+
+    TEST_ASSERT(pool.size() == 200);
+
+    pool.destroy_all();
+    TEST_ASSERT(pool.empty());
+
+    TEST_PASS(nullptr);
+}
+#endif
+
+
+
+
+static stest_func split_tests[] =
+{
+    split_test_size,
+    split_test_create_destroy,
+    split_test_move,
+#ifdef NEED_RESERVE
+    split_test_compact,
+    split_test_grow,
+#endif
+};
+
+
+
+
+
+#endif // SPLIT_TESTS_H
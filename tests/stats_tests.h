@@ -0,0 +1,197 @@
+#ifndef STATS_TESTS_H
+#define STATS_TESTS_H
+
+#include <array>
+#include <utility>
+#include <type_traits>
+
+#include "stest.h"
+#include "helpers.h"
+#include "pool.h"
+
+
+
+
+using namespace pool;
+
+
+
+
+TEST(stats_test_counters)
+{
+    const size_t N = 16;
+    Pool<Temp_struct, N, alignof(Temp_struct), POOL_STATS, IMPL> pool;
+
+    auto st = pool.stats();
+    TEST_ASSERT(st.creates    == 0);
+    TEST_ASSERT(st.destroys   == 0);
+    TEST_ASSERT(st.high_water == 0);
+
+    std::array<Temp_struct*, N> objs;
+
+    for(size_t i = 0; i < N/2; i++)
+        objs[i] = pool.create(int(i));
+
+    TEST_ASSERT(pool.create_n(objs.data() + N/2, N/2, 7) == N/2);
+
+    for(size_t i = 0; i < N/4; i++)
+        pool.destroy(objs[i]);
+
+    st = pool.stats();
+    TEST_ASSERT(st.creates    == N);
+    TEST_ASSERT(st.destroys   == N/4);
+    TEST_ASSERT(st.size       == N - N/4);
+    TEST_ASSERT(st.high_water == N);
+    TEST_ASSERT(st.capacity   == pool.capacity());
+
+    //the node contains the object
+    TEST_ASSERT(st.bytes_per_node >= sizeof(Temp_struct));
+    TEST_ASSERT(st.padding >= 0.0 && st.padding < 1.0);
+    TEST_ASSERT(st.bytes_reserved >= st.capacity * sizeof(Temp_struct));
+
+    for(size_t i = N/4; i < N; i++)
+        pool.destroy(objs[i]);
+
+    st = pool.stats();
+    TEST_ASSERT(st.creates    == N);
+    TEST_ASSERT(st.destroys   == N);
+    TEST_ASSERT(st.high_water == N);
+
+    TEST_ASSERT(Temp_struct::cnt == 0);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(stats_test_padding)
+{
+    Pool<char, 4, 64, POOL_STATS, IMPL> pool;
+
+    auto obj = pool.create('x');
+    TEST_ASSERT(obj);
+
+    auto st = pool.stats();
+    TEST_ASSERT(st.bytes_per_node >= 64);
+    TEST_ASSERT(st.padding >= 63.0 / 64.0);
+
+    pool.destroy(obj);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+//The counters are moved with the objects (SPool_idlist and the dynamic pools)
+template <class Pool_type>
+static struct test_info_t stats_move(struct test_case_t *test_case)
+{
+    if constexpr(std::is_move_constructible_v<Pool_type>)
+    {
+        Pool_type pool;
+        std::array<int*, 8> objs;
+
+        for(auto &obj: objs)
+            obj = pool.create(1);
+
+        pool.destroy(objs[0]);
+
+        Pool_type pool2(std::move(pool));
+
+        auto st = pool2.stats();
+        TEST_ASSERT(st.creates    == 8);
+        TEST_ASSERT(st.destroys   == 1);
+        TEST_ASSERT(st.size       == 7);
+        TEST_ASSERT(st.high_water == 8);
+
+        st = pool.stats();
+        TEST_ASSERT(st.creates    == 0);
+        TEST_ASSERT(st.destroys   == 0);
+        TEST_ASSERT(st.high_water == 0);
+
+        //the assignment (the counters of pool are replaced)
+        pool.destroy(pool.create(2));
+        pool = std::move(pool2);
+
+        st = pool.stats();
+        TEST_ASSERT(st.creates  == 8);
+        TEST_ASSERT(st.destroys == 1);
+        TEST_ASSERT(st.size     == 7);
+
+        TEST_ASSERT(pool2.stats().destroys == 0);
+
+        pool.destroy_n(objs.data() + 1, objs.size() - 1);
+        TEST_ASSERT(pool.empty());
+    }
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(stats_test_move)
+{
+    return stats_move<Pool<int, 16, alignof(int), POOL_STATS, IMPL>>(test_case);
+}
+
+
+
+#ifdef NEED_RESERVE
+TEST(stats_test_grow_shrink)
+{
+    const size_t N = 4;
+    Pool<int, N, alignof(int), POOL_STATS, IMPL> pool;
+
+    std::array<int*, 3 * N> objs;
+
+    for(auto &obj: objs)
+        obj = pool.create(1);
+
+    auto st = pool.stats();
+    TEST_ASSERT(st.grows        >= 3); //3 blocks or 3 * N nodes
+    TEST_ASSERT(st.failed_grows == 0);
+    TEST_ASSERT(st.shrinks      == 0);
+    TEST_ASSERT(st.capacity     >= 3 * N);
+    TEST_ASSERT(st.bytes_reserved >= st.capacity * st.bytes_per_node);
+
+    for(auto obj: objs)
+        pool.destroy(obj);
+
+    pool.shrink_to_fit();
+
+    st = pool.stats();
+    TEST_ASSERT(st.shrinks        == st.grows);
+    TEST_ASSERT(st.capacity       == 0);
+    TEST_ASSERT(st.bytes_reserved == 0);
+    TEST_ASSERT(st.high_water     == 3 * N);
+
+
+    //the source without memory
+    Pool<int, N, alignof(int), POOL_STATS, IMPL, Pool_buffer_source> pool2;
+
+    TEST_ASSERT(pool2.create(1) == nullptr);
+    TEST_ASSERT(pool2.stats().failed_grows == 1);
+    TEST_ASSERT(pool2.stats().creates      == 0);
+
+    TEST_PASS(nullptr);
+}
+#endif
+
+
+
+
+static stest_func stats_tests[] =
+{
+    stats_test_counters,
+    stats_test_padding,
+    stats_test_move,
+#ifdef NEED_RESERVE
+    stats_test_grow_shrink,
+#endif
+};
+
+
+
+
+
+#endif // STATS_TESTS_H
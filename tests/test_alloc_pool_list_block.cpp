@@ -0,0 +1,8 @@
+
+#define IMPL Pool_list_block
+
+#include "allocator_tests.h"
+
+
+
+TEST_CASE(alloc_case_pool_list_block, alloc_tests, NULL, test_init_func, NULL)
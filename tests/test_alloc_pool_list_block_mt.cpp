@@ -0,0 +1,8 @@
+
+#define IMPL Pool_list_block_mt
+
+#include "allocator_tests.h"
+
+
+
+TEST_CASE(alloc_case_pool_list_block_mt, alloc_tests, NULL, test_init_func, NULL)
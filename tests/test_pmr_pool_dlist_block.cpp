@@ -0,0 +1,8 @@
+
+#define IMPL Pool_dlist_block
+
+#include "pmr_tests.h"
+
+
+
+TEST_CASE(pmr_case_pool_dlist_block, pmr_tests, NULL, test_init_func, NULL)
@@ -6,6 +6,10 @@
 #include "ex_tests.h"
 #include "ex_dynamic_tests.h"
 #include "iterator_tests.h"
+#include "bulk_tests.h"
+#include "source_tests.h"
+#include "stats_tests.h"
+#include "parallel_tests.h"
 
 
 
@@ -13,3 +17,7 @@ TEST_CASE(base_case_pool_dlist,       base_tests,       NULL, test_init_func, NU
 TEST_CASE(ex_case_pool_dlist,         ex_tests,         NULL, test_init_func, NULL)
 TEST_CASE(ex_dinamic_case_pool_dlist, ex_dynamic_tests, NULL, test_init_func, NULL)
 TEST_CASE(iter_case_pool_dlist,       iter_tests,       NULL, test_init_func, NULL)
+TEST_CASE(bulk_case_pool_dlist,       bulk_tests,       NULL, test_init_func, NULL)
+TEST_CASE(src_case_pool_dlist,        src_tests,        NULL, test_init_func, NULL)
+TEST_CASE(stats_case_pool_dlist,      stats_tests,      NULL, test_init_func, NULL)
+TEST_CASE(parallel_case_pool_dlist,   parallel_tests,   NULL, test_init_func, NULL)
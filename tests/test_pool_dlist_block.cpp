@@ -6,6 +6,15 @@
 #include "ex_tests.h"
 #include "ex_dynamic_tests.h"
 #include "iterator_tests.h"
+#include "bulk_tests.h"
+#include "source_tests.h"
+#include "trim_tests.h"
+#include "handle_tests.h"
+#include "stats_tests.h"
+#include "parallel_tests.h"
+#include "compact_tests.h"
+#include "snapshot_tests.h"
+#include "split_tests.h"
 
 
 
@@ -13,3 +22,12 @@ TEST_CASE(base_case_pool_dlist_block,       base_tests,       NULL, test_init_fu
 TEST_CASE(ex_case_pool_dlist_block,         ex_tests,         NULL, test_init_func, NULL)
 TEST_CASE(ex_dinamic_case_pool_dlist_block, ex_dynamic_tests, NULL, test_init_func, NULL)
 TEST_CASE(iter_case_pool_dlist_block,       iter_tests,       NULL, test_init_func, NULL)
+TEST_CASE(bulk_case_pool_dlist_block,       bulk_tests,       NULL, test_init_func, NULL)
+TEST_CASE(src_case_pool_dlist_block,        src_tests,        NULL, test_init_func, NULL)
+TEST_CASE(trim_case_pool_dlist_block,       trim_tests,       NULL, test_init_func, NULL)
+TEST_CASE(handle_case_pool_dlist_block,     handle_tests,     NULL, test_init_func, NULL)
+TEST_CASE(stats_case_pool_dlist_block,      stats_tests,      NULL, test_init_func, NULL)
+TEST_CASE(parallel_case_pool_dlist_block,   parallel_tests,   NULL, test_init_func, NULL)
+TEST_CASE(compact_case_pool_dlist_block,    compact_tests,    NULL, test_init_func, NULL)
+TEST_CASE(snapshot_case_pool_dlist_block,   snapshot_tests,   NULL, test_init_func, NULL)
+TEST_CASE(split_case_pool_dlist_block,      split_tests,      NULL, test_init_func, NULL)
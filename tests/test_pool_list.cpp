@@ -4,8 +4,14 @@
 
 #include "base_tests.h"
 #include "ex_dynamic_tests.h"
+#include "bulk_tests.h"
+#include "source_tests.h"
+#include "stats_tests.h"
 
 
 
 TEST_CASE(base_case_pool_list,       base_tests,       NULL, test_init_func, NULL)
 TEST_CASE(ex_dinamic_case_pool_list, ex_dynamic_tests, NULL, test_init_func, NULL)
+TEST_CASE(bulk_case_pool_list,       bulk_tests,       NULL, test_init_func, NULL)
+TEST_CASE(src_case_pool_list,        src_tests,        NULL, test_init_func, NULL)
+TEST_CASE(stats_case_pool_list,      stats_tests,      NULL, test_init_func, NULL)
@@ -4,8 +4,18 @@
 
 #include "base_tests.h"
 #include "ex_dynamic_tests.h"
+#include "bulk_tests.h"
+#include "source_tests.h"
+#include "trim_tests.h"
+#include "handle_tests.h"
+#include "stats_tests.h"
 
 
 
 TEST_CASE(base_case_pool_list_block,       base_tests,       NULL, test_init_func, NULL)
 TEST_CASE(ex_dinamic_case_pool_list_block, ex_dynamic_tests, NULL, test_init_func, NULL)
+TEST_CASE(bulk_case_pool_list_block,       bulk_tests,       NULL, test_init_func, NULL)
+TEST_CASE(src_case_pool_list_block,        src_tests,        NULL, test_init_func, NULL)
+TEST_CASE(trim_case_pool_list_block,       trim_tests,       NULL, test_init_func, NULL)
+TEST_CASE(handle_case_pool_list_block,     handle_tests,     NULL, test_init_func, NULL)
+TEST_CASE(stats_case_pool_list_block,      stats_tests,      NULL, test_init_func, NULL)
@@ -0,0 +1,17 @@
+
+#define IMPL Pool_list_mt
+#define NEED_RESERVE
+
+#include "base_tests.h"
+#include "ex_dynamic_tests.h"
+#include "mt_tests.h"
+#include "bulk_tests.h"
+#include "source_tests.h"
+
+
+
+TEST_CASE(base_case_pool_list_mt,       base_tests,       NULL, test_init_func, NULL)
+TEST_CASE(ex_dinamic_case_pool_list_mt, ex_dynamic_tests, NULL, test_init_func, NULL)
+TEST_CASE(mt_case_pool_list_mt,         mt_tests,         NULL, test_init_func, NULL)
+TEST_CASE(bulk_case_pool_list_mt,       bulk_tests,       NULL, test_init_func, NULL)
+TEST_CASE(src_case_pool_list_mt,        src_tests,        NULL, test_init_func, NULL)
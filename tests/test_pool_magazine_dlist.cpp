@@ -0,0 +1,8 @@
+
+#define IMPL Pool_dlist_block
+
+#include "magazine_tests.h"
+
+
+
+TEST_CASE(mag_case_pool_dlist_block, magazine_tests, NULL, test_init_func, NULL)
@@ -0,0 +1,8 @@
+
+#define IMPL Pool_dlist_block
+
+#include "size_classes_tests.h"
+
+
+
+TEST_CASE(sc_case_pool_dlist_block, sc_tests, NULL, test_init_func, NULL)
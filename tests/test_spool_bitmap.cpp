@@ -0,0 +1,20 @@
+
+#define IMPL SPool_bitmap
+
+#include "base_tests.h"
+#include "ex_tests.h"
+#include "iterator_tests.h"
+#include "bulk_tests.h"
+#include "handle_tests.h"
+#include "parallel_tests.h"
+#include "snapshot_tests.h"
+
+
+
+TEST_CASE(base_case_spool_bitmap,     base_tests,     NULL, test_init_func, NULL)
+TEST_CASE(ex_case_spool_bitmap,       ex_tests,       NULL, test_init_func, NULL)
+TEST_CASE(iter_case_spool_bitmap,     iter_tests,     NULL, test_init_func, NULL)
+TEST_CASE(bulk_case_spool_bitmap,     bulk_tests,     NULL, test_init_func, NULL)
+TEST_CASE(handle_case_spool_bitmap,   handle_tests,   NULL, test_init_func, NULL)
+TEST_CASE(parallel_case_spool_bitmap, parallel_tests, NULL, test_init_func, NULL)
+TEST_CASE(snapshot_case_spool_bitmap, snapshot_tests, NULL, test_init_func, NULL)
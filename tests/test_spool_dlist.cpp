@@ -4,9 +4,23 @@
 #include "base_tests.h"
 #include "ex_tests.h"
 #include "iterator_tests.h"
+#include "bulk_tests.h"
+#include "handle_tests.h"
+#include "stats_tests.h"
+#include "parallel_tests.h"
+#include "snapshot_tests.h"
+#include "lazy_tests.h"
+#include "split_tests.h"
 
 
 
-TEST_CASE(base_case_spool_dlist, base_tests, NULL, test_init_func, NULL)
-TEST_CASE(ex_case_spool_dlist,   ex_tests,   NULL, test_init_func, NULL)
-TEST_CASE(iter_case_spool_dlist, iter_tests, NULL, test_init_func, NULL)
+TEST_CASE(base_case_spool_dlist,     base_tests,     NULL, test_init_func, NULL)
+TEST_CASE(ex_case_spool_dlist,       ex_tests,       NULL, test_init_func, NULL)
+TEST_CASE(iter_case_spool_dlist,     iter_tests,     NULL, test_init_func, NULL)
+TEST_CASE(bulk_case_spool_dlist,     bulk_tests,     NULL, test_init_func, NULL)
+TEST_CASE(handle_case_spool_dlist,   handle_tests,   NULL, test_init_func, NULL)
+TEST_CASE(stats_case_spool_dlist,    stats_tests,    NULL, test_init_func, NULL)
+TEST_CASE(parallel_case_spool_dlist, parallel_tests, NULL, test_init_func, NULL)
+TEST_CASE(snapshot_case_spool_dlist, snapshot_tests, NULL, test_init_func, NULL)
+TEST_CASE(lazy_case_spool_dlist,     lazy_tests,     NULL, test_init_func, NULL)
+TEST_CASE(split_case_spool_dlist,    split_tests,    NULL, test_init_func, NULL)
@@ -0,0 +1,26 @@
+
+#define IMPL SPool_idlist
+
+#include "base_tests.h"
+#include "ex_tests.h"
+#include "iterator_tests.h"
+#include "bulk_tests.h"
+#include "handle_tests.h"
+#include "relocate_tests.h"
+#include "split_tests.h"
+#include "parallel_tests.h"
+#include "snapshot_tests.h"
+#include "stats_tests.h"
+
+
+
+TEST_CASE(base_case_spool_idlist,     base_tests,     NULL, test_init_func, NULL)
+TEST_CASE(ex_case_spool_idlist,       ex_tests,       NULL, test_init_func, NULL)
+TEST_CASE(iter_case_spool_idlist,     iter_tests,     NULL, test_init_func, NULL)
+TEST_CASE(bulk_case_spool_idlist,     bulk_tests,     NULL, test_init_func, NULL)
+TEST_CASE(handle_case_spool_idlist,   handle_tests,   NULL, test_init_func, NULL)
+TEST_CASE(relocate_case_spool_idlist, relocate_tests, NULL, test_init_func, NULL)
+TEST_CASE(split_case_spool_idlist,    split_tests,    NULL, test_init_func, NULL)
+TEST_CASE(parallel_case_spool_idlist, parallel_tests, NULL, test_init_func, NULL)
+TEST_CASE(snapshot_case_spool_idlist, snapshot_tests, NULL, test_init_func, NULL)
+TEST_CASE(stats_case_spool_idlist,    stats_tests,    NULL, test_init_func, NULL)
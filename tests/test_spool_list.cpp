@@ -3,8 +3,16 @@
 
 #include "base_tests.h"
 #include "ex_tests.h"
+#include "bulk_tests.h"
+#include "handle_tests.h"
+#include "stats_tests.h"
+#include "lazy_tests.h"
 
 
 
-TEST_CASE(base_case_spool_list, base_tests, NULL, test_init_func, NULL)
-TEST_CASE(ex_case_spool_list,   ex_tests,   NULL, test_init_func, NULL)
+TEST_CASE(base_case_spool_list,   base_tests,   NULL, test_init_func, NULL)
+TEST_CASE(ex_case_spool_list,     ex_tests,     NULL, test_init_func, NULL)
+TEST_CASE(bulk_case_spool_list,   bulk_tests,   NULL, test_init_func, NULL)
+TEST_CASE(handle_case_spool_list, handle_tests, NULL, test_init_func, NULL)
+TEST_CASE(stats_case_spool_list,  stats_tests,  NULL, test_init_func, NULL)
+TEST_CASE(lazy_case_spool_list,   lazy_tests,   NULL, test_init_func, NULL)
@@ -4,9 +4,19 @@
 #include "base_tests.h"
 #include "ex_tests.h"
 #include "iterator_tests.h"
+#include "bulk_tests.h"
+#include "handle_tests.h"
+#include "parallel_tests.h"
+#include "lazy_tests.h"
+#include "stats_tests.h"
 
 
 
-TEST_CASE(base_case_spool_list_bitset, base_tests, NULL, test_init_func, NULL)
-TEST_CASE(ex_case_spool_list_bitset,   ex_tests,   NULL, test_init_func, NULL)
-TEST_CASE(iter_case_spool_list_bitset, iter_tests, NULL, test_init_func, NULL)
+TEST_CASE(base_case_spool_list_bitset,     base_tests,     NULL, test_init_func, NULL)
+TEST_CASE(ex_case_spool_list_bitset,       ex_tests,       NULL, test_init_func, NULL)
+TEST_CASE(iter_case_spool_list_bitset,     iter_tests,     NULL, test_init_func, NULL)
+TEST_CASE(bulk_case_spool_list_bitset,     bulk_tests,     NULL, test_init_func, NULL)
+TEST_CASE(handle_case_spool_list_bitset,   handle_tests,   NULL, test_init_func, NULL)
+TEST_CASE(parallel_case_spool_list_bitset, parallel_tests, NULL, test_init_func, NULL)
+TEST_CASE(lazy_case_spool_list_bitset,     lazy_tests,     NULL, test_init_func, NULL)
+TEST_CASE(stats_case_spool_list_bitset,    stats_tests,    NULL, test_init_func, NULL)
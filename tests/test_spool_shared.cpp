@@ -0,0 +1,14 @@
+
+#define IMPL SPool_shared
+
+#include "base_tests.h"
+#include "mt_tests.h"
+#include "bulk_tests.h"
+#include "shared_tests.h"
+
+
+
+TEST_CASE(base_case_spool_shared,   base_tests,   NULL, test_init_func, NULL)
+TEST_CASE(mt_case_spool_shared,     mt_tests,     NULL, test_init_func, NULL)
+TEST_CASE(bulk_case_spool_shared,   bulk_tests,   NULL, test_init_func, NULL)
+TEST_CASE(shared_case_spool_shared, shared_tests, NULL, test_init_func, NULL)
@@ -0,0 +1,305 @@
+#ifndef TRIM_TESTS_H
+#define TRIM_TESTS_H
+
+#include <vector>
+
+#include "stest.h"
+#include "helpers.h"
+#include "pool.h"
+
+
+
+
+using namespace pool;
+
+
+
+
+TEST(trim_test_shrink_to_fit)
+{
+    TEST_ASSERT(Temp_struct::cnt == 0);
+
+    {
+        Pool<Temp_struct, 16, 16, POOL_TRIM_BLOCKS, IMPL> pool;
+        std::vector<Temp_struct*> objs;
+
+        for(int i = 0; i < 10000; i++)
+            objs.push_back(pool.create(i));
+
+        const auto peak = pool.capacity();
+        TEST_ASSERT(peak                >= 10000);
+        TEST_ASSERT(pool.empty_blocks() == 0);
+
+        //the blocks of the first objects become empty
+        for(int i = 0; i < 9000; i++)
+            pool.destroy(objs[i]);
+
+        TEST_ASSERT(pool.empty_blocks() > 0);
+        TEST_ASSERT(pool.capacity()     == peak);
+
+        pool.shrink_to_fit();
+        TEST_ASSERT(pool.empty_blocks() == 0);
+        TEST_ASSERT(pool.size()         == 1000);
+        TEST_ASSERT(pool.capacity()     <  peak / 5);
+        TEST_ASSERT(pool.capacity()     >= pool.size());
+
+        for(int i = 9000; i < 10000; i++)
+            TEST_ASSERT(objs[i]->tag == i);
+
+        //the free nodes of the rest blocks are still in the pool
+        for(int i = 0; i < 9000; i++)
+        {
+            objs[i] = pool.create(i);
+            TEST_ASSERT(objs[i] != nullptr);
+        }
+
+        TEST_ASSERT(Temp_struct::cnt == 10000);
+
+        for(auto obj: objs)
+            pool.destroy(obj);
+
+        TEST_ASSERT(pool.empty_blocks() > 0);
+
+        pool.shrink_to_fit(100);
+        TEST_ASSERT(pool.capacity() >= 100);
+        TEST_ASSERT(pool.capacity() <  peak);
+
+        pool.shrink_to_fit();
+        TEST_ASSERT(pool.capacity()     == 0);
+        TEST_ASSERT(pool.empty_blocks() == 0);
+    }
+
+    TEST_ASSERT(Temp_struct::cnt == 0);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(trim_test_threshold)
+{
+    Pool<Temp_struct, 16, 16, POOL_TRIM_BLOCKS | POOL_GROW_BLOCKS, IMPL> pool;
+    pool.trim_threshold(2);
+
+    std::vector<Temp_struct*> objs;
+
+    for(int i = 0; i < 5000; i++)
+        objs.push_back(pool.create(i));
+
+    const auto peak = pool.capacity();
+
+    //destroy in the order of creation: each emptied block is trimmed at once
+    for(int i = 0; i < 4000; i++)
+    {
+        pool.destroy(objs[i]);
+        TEST_ASSERT(pool.empty_blocks() <= 2);
+    }
+
+    TEST_ASSERT(pool.capacity()     <  peak);
+    TEST_ASSERT(pool.size()         == 1000);
+    TEST_ASSERT(pool.empty_blocks() == 2); //the trim keeps the threshold
+
+    for(int i = 4000; i < 5000; i++)
+    {
+        TEST_ASSERT(objs[i]->tag == i);
+        pool.destroy(objs[i]);
+    }
+
+    TEST_ASSERT(pool.empty_blocks() <= 2);
+    TEST_ASSERT(Temp_struct::cnt    == 0);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(trim_test_create_n_move)
+{
+    Pool<Temp_struct, 8, 16, POOL_TRIM_BLOCKS, IMPL> pool;
+
+    std::array<Temp_struct*, 100> objs;
+    TEST_ASSERT(pool.create_n(objs.data(), objs.size(), 5) == objs.size());
+
+    pool.destroy_n(objs.data(), 50);
+
+    auto pool2 = std::move(pool);
+    TEST_ASSERT(pool.capacity()  == 0);
+    TEST_ASSERT(pool2.size()     == 50);
+
+    pool2.shrink_to_fit();
+    TEST_ASSERT(pool2.capacity() >= 50);
+    TEST_ASSERT(pool2.capacity() <  100);
+
+    pool2.destroy_n(objs.data() + 50, 50);
+    pool2.shrink_to_fit();
+    TEST_ASSERT(pool2.capacity() == 0);
+    TEST_ASSERT(Temp_struct::cnt == 0);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+
+TEST(trim_test_fullest_block)
+{
+    TEST_ASSERT(Temp_struct::cnt == 0);
+
+    {
+        Pool<Temp_struct, 16, 16, POOL_FULLEST_BLOCK, IMPL> pool;
+        std::vector<Temp_struct*> objs;
+
+        for(int i = 0; i < 10000; i++)
+            objs.push_back(pool.create(i));
+
+        const auto peak = pool.capacity();
+
+        //the blocks of the second half are half full
+        for(int i = 5001; i < 10000; i += 2)
+            pool.destroy(objs[i]);
+
+        //the blocks of the first half are nearly empty, their nodes are freed last
+        for(int i = 0; i < 5000; i++)
+        {
+            if(i % 100)
+                pool.destroy(objs[i]);
+        }
+
+        //the new objects go to the fullest blocks (the second half)
+        for(int i = 5001; i < 10000; i += 2)
+        {
+            objs[i] = pool.create(i);
+            TEST_ASSERT(objs[i] != nullptr);
+        }
+
+        TEST_ASSERT(pool.capacity() == peak);
+
+        //so the blocks of the first half become empty and can be released
+        for(int i = 0; i < 5000; i += 100)
+            pool.destroy(objs[i]);
+
+        pool.shrink_to_fit();
+        TEST_ASSERT(pool.empty_blocks() == 0);
+        TEST_ASSERT(pool.size()         == 5000);
+        TEST_ASSERT(pool.capacity()     <  peak * 6 / 10);
+
+        for(int i = 5000; i < 10000; i++)
+        {
+            TEST_ASSERT(objs[i]->tag == i);
+            pool.destroy(objs[i]);
+        }
+
+        pool.shrink_to_fit();
+        TEST_ASSERT(pool.capacity() == 0);
+    }
+
+    TEST_ASSERT(Temp_struct::cnt == 0);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+TEST(trim_test_fullest_create_n)
+{
+    Pool<Temp_struct, 8, 16, POOL_FULLEST_BLOCK | POOL_GROW_BLOCKS, IMPL> pool;
+    pool.trim_threshold(1);
+
+    std::array<Temp_struct*, 300> objs;
+
+    pool.reserve(50);
+    TEST_ASSERT(pool.create_n(objs.data(), objs.size(), 5) == objs.size());
+    TEST_ASSERT(pool.size()         == objs.size());
+    TEST_ASSERT(pool.empty_blocks() == 0);
+
+    //every 3rd object stays
+    for(std::size_t i = 0; i < objs.size(); i++)
+    {
+        if(i % 3)
+            pool.destroy(objs[i]);
+    }
+
+    for(std::size_t i = 0; i < objs.size(); i++)
+    {
+        if(i % 3)
+        {
+            objs[i] = pool.create(7);
+            TEST_ASSERT(objs[i] != nullptr);
+        }
+    }
+
+    auto pool2 = std::move(pool);
+    TEST_ASSERT(pool.capacity() == 0);
+    TEST_ASSERT(pool2.size()    == objs.size());
+
+    for(std::size_t i = 0; i < objs.size(); i++)
+    {
+        TEST_ASSERT(objs[i]->tag == (i % 3 ? 7 : 5));
+        pool2.destroy(objs[i]);
+        TEST_ASSERT(pool2.empty_blocks() <= 1);
+    }
+
+    pool2.shrink_to_fit();
+    TEST_ASSERT(pool2.capacity() == 0);
+    TEST_ASSERT(Temp_struct::cnt == 0);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+
+TEST(trim_test_block_size)
+{
+    //the tracking of blocks doesn't change the count of nodes in the block
+    Pool<Temp_struct, 100, 16, POOL_TRIM_BLOCKS,   IMPL> trim;
+    Pool<Temp_struct, 100, 16, POOL_FULLEST_BLOCK, IMPL> fullest;
+    Pool<Temp_struct, 100, 16, POOL_TRIM_BLOCKS | POOL_GROW_BLOCKS, IMPL> grow;
+
+    trim.reserve(1);
+    fullest.reserve(1);
+    TEST_ASSERT(trim.capacity()    == 100);
+    TEST_ASSERT(fullest.capacity() == 100);
+
+    //the blocks of 100, 200, 400 nodes
+    for(int i = 0; i < 3; i++)
+        grow.reserve(grow.capacity() + 1);
+
+    TEST_ASSERT(grow.capacity() == 700);
+
+    std::vector<Temp_struct*> objs;
+
+    for(int i = 0; i < 700; i++)
+        objs.push_back(grow.create(i));
+
+    TEST_ASSERT(grow.capacity()     == 700);
+    TEST_ASSERT(grow.empty_blocks() == 0);
+
+    //the blocks are found by the address of node
+    for(auto obj: objs)
+        grow.destroy(obj);
+
+    TEST_ASSERT(grow.empty_blocks() == 3);
+    TEST_ASSERT(Temp_struct::cnt    == 0);
+
+    TEST_PASS(nullptr);
+}
+
+
+
+
+static stest_func trim_tests[] =
+{
+    trim_test_shrink_to_fit,
+    trim_test_threshold,
+    trim_test_create_n_move,
+    trim_test_fullest_block,
+    trim_test_fullest_create_n,
+    trim_test_block_size,
+};
+
+
+
+
+
+#endif // TRIM_TESTS_H